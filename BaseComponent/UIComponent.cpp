@@ -11,6 +11,38 @@ namespace UIMiniEmbed {
 	struct UIRenderContext {
 		float        opacity = 1;
 		Utils::Color color;
+		
+		/// intersection of the outer boxes of every clip container above
+		BBox         clip;
+		bool         hasClip = false;
+		
+		bool isVisible(const BBox& bbox) const {
+			return !hasClip || ( clip.isValid() && clip.isIntersect(bbox) );
+		}
+		
+		bool operator == (const UIRenderContext& other) const {
+			return opacity == other.opacity && hasClip == other.hasClip && clip == other.clip &&
+				!std::memcmp( &color, &other.color, sizeof(color) );
+		}
+		bool operator != (const UIRenderContext& other) const { return !( *this == other ); }
+	};
+
+	/// Render nodes visited by the last recording, culled subtrees count every node in them
+	struct UIDrawStats {
+		size_t drawnCount             = 0;
+		size_t culledTransparentCount = 0;
+		size_t culledOffscreenCount   = 0;
+		/// draw commands removed by occlusion culling
+		size_t occludedCommandCount   = 0;
+		/// nodes not recorded because their layer was still valid
+		size_t layerCachedCount       = 0;
+	};
+
+	/// What update() may need from outside the tree, spApi may be null
+	struct UIUpdateContext {
+		SP_UIRenderDriverApi spApi      = nullptr;
+		/// sprite paths packed into atlases, see UISpriteAtlasPacker
+		SP_UISpriteAtlasMap  spAtlasMap = nullptr;
 	};
 
 	class UIComponent;
@@ -20,17 +52,50 @@ namespace UIMiniEmbed {
 
 	SP_UIComponent createUINode(SP_UINodeDesc spNodeDesc, SP_UIVarEnv spVarEnv = nullptr, SP_UIComponent spParentNode = nullptr);
 	
+	/// Replaces the recursive update_PositionWalk of a root, see UILayoutFlat and UILayoutParallel
+	class UILayoutEngine {
+		public:
+			virtual ~UILayoutEngine() {}
+			/// true when any box changed
+			virtual bool layout(UIComponent& root) = 0;
+			/// the boxes may have been written by someone else since the last layout()
+			virtual void reset() {}
+	};
+	using SP_UILayoutEngine = std::shared_ptr< UILayoutEngine >;
+	
+	/// Replaces the recursive draw walk of recordCommandBuffer, see UIRecordParallel.
+	/// Appends to cmdBuffer and adds to stats exactly what the serial walk would.
+	class UIRecordEngine {
+		public:
+			virtual ~UIRecordEngine() {}
+			virtual void record(UIComponent& root, UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& parentRCtx, const BBox& viewport, UIDrawStats& stats) = 0;
+	};
+	using SP_UIRecordEngine = std::shared_ptr< UIRecordEngine >;
+	
 	class UIComponent : public std::enable_shared_from_this< UIComponent > {
+		friend class UILayoutFlat;
+		friend class UILayoutParallel;
+		friend class UIRecordParallel;
+		
 		public:
-			virtual ~UIComponent() {}
+			virtual ~UIComponent() {
+				auto spLayerApi = _wpLayerApi.lock();
+				if ( spLayerApi && _layerHandle )
+					spLayerApi->releaseLayer(_layerHandle);
+			}
 
 		private:
 			SP_UINodeDesc   _spNodeDesc = nullptr;
 			SP_UIVarEnv     _spVarEnv   = nullptr;
 			WP_UIComponent  _wpParentNode;
+			/// env each $ prop took its var from, in prop order
+			std::vector< UIVarEnv* > _externalVarEnvList;
+			/// bumped by rebindWalk(), folded into the layout and draw sequences
+			uint64_t        _bindSequence = 0;
 
 			UIComponentList _childNodeList;
 			UIComponentList _childRenderNodeList;
+			UIComponentList _prevChildRenderNodeList;
 
 		protected:
 			SP_UIComponent   getParentNodeOrNull      () { return _wpParentNode.lock(); }
@@ -55,6 +120,13 @@ namespace UIMiniEmbed {
 			}
 
 		private:
+			void _link_ExternalVar(const UINodePropDesc& prop, UIVarEnv* pVarEnv) {
+				auto var = pVarEnv->getVar( prop.getValue() );
+				for(auto path : prop.getFetchPath())
+					var = var.map_Get(path);
+				setVar( prop.getName(), var );
+			}
+
 			void _init_Var(SP_UINodeDesc& spNodeDesc) {
 				for(const auto prop : spNodeDesc->getProps()) {
 					switch( prop.getType() ) {
@@ -67,10 +139,9 @@ namespace UIMiniEmbed {
 						case UINodePropDesc::ConstNumberFraction: getVar( prop.getName() ).setFraction( stringToFloat( prop.getValue() )          ); break;	
 						
 						case UINodePropDesc::VarExternal: {
-							auto var = getVar( prop.getValue(), true );
-							for(auto path : prop.getFetchPath())
-								var = var.map_Get(path);
-							setVar( prop.getName(), var );
+							auto pVarEnv = _spVarEnv->getVarOwner( prop.getValue() );
+							_externalVarEnvList.push_back(pVarEnv);
+							_link_ExternalVar(prop, pVarEnv);
 						};
 						break;
 					}
@@ -87,6 +158,21 @@ namespace UIMiniEmbed {
 				_init_VarLink();
 			}
 			
+			/// Takes every $ prop of the subtree again from the env it came from and relinks the vars,
+			/// after a var of an ancestor env was replaced, e.g. the $item of a recycled VirtualList row.
+			void rebindWalk() {
+				size_t index = 0;
+				for(const auto& prop : _spNodeDesc->getProps())
+					if ( prop.getType() == UINodePropDesc::VarExternal )
+						_link_ExternalVar( prop, _externalVarEnvList[index++] );
+
+				_init_VarLink();
+				_bindSequence = var_NextSequence();
+
+				for( auto& childNode : getChildNodeListRef() )
+					childNode->rebindWalk();
+			}
+			
 		
 		
 
@@ -123,6 +209,9 @@ namespace UIMiniEmbed {
 			
 			UIVar _opacity;
 			UIVar _color;
+			UIVar _clip;
+			UIVar _opaque;
+			UIVar _layer;
 			
 		protected:
 			static UIPosValVariant _getPosVariant(const UIVar& var) {
@@ -139,9 +228,20 @@ namespace UIMiniEmbed {
 				return UIPosValVariant{ UIPosValVariant::Pixel, var.getFloat() };
 			}
 				
+			template< class... TVars >
+			static uint64_t _getMaxSequence(const TVars&... vars) {
+				uint64_t seq = 0;
+				( ( seq = ( seq < vars.getInvalidateSequence() ) ? vars.getInvalidateSequence() : seq ), ... );
+				return seq;
+			}
+				
 			static UIEnumAlign _getAlign(const UIVar& var) {
-				if ( var.getString() == "center" ) return UIEnumAlign::Center;
-				if ( var.getString() == "end"    ) return UIEnumAlign::End;				
+				static const UIString sCenter ("center");
+				static const UIString sEnd    ("end");
+
+				const auto value = var.getUIString();
+				if ( value == sCenter ) return UIEnumAlign::Center;
+				if ( value == sEnd    ) return UIEnumAlign::End;
 				return UIEnumAlign::Start;
 			}
 
@@ -175,8 +275,28 @@ namespace UIMiniEmbed {
 				
 				_opacity = getVar("opacity");
 				_color   = getVar("color");
+				_clip    = getVar("clip");
+				_opaque  = getVar("opaque");
+				_layer   = getVar("layer");
+			}
+		
+		
+			/// Newest invalidate sequence among every var draw() reads from this node, besides its boxes.
+			/// Components drawing from extra vars or state must fold them in, or the retained draw list goes stale.
+			virtual uint64_t _getDrawSequence() {
+				return _getMaxSequence( _opacity, _color, _clip, _opaque, _layer );
 			}
 		
+			/// Newest invalidate sequence among every var the layout reads from this node.
+			/// Components whose style getters depend on extra vars must fold them in.
+			virtual uint64_t _getLayoutSequence() {
+				return _getMaxSequence(
+					_left, _right, _top, _bottom,
+					_padding, _paddingLeft, _paddingRight, _paddingTop, _paddingBottom,
+					_widthHeight, _width, _height,
+					_gap, _relative, _absolute, _dirColumn, _alignX, _alignY
+				);
+			}
 		
 			virtual UIPosValVariant     getStyleWidth        () { return _getPosVariant( _width .isNull() ? _widthHeight : _width  ); }
 			virtual UIPosValVariant     getStyleHeight       () { return _getPosVariant( _height.isNull() ? _widthHeight : _height ); }
@@ -221,6 +341,13 @@ namespace UIMiniEmbed {
 				return clamp(0, _opacity.getFloat(), 1);
 			}
 			
+			/// render descendants are cut to the outer box, in draw and in hover search
+			virtual bool            getStyleClip() { return _clip.getBool(); }
+			/// promise that draw() covers the inner box with opaque pixels, lets occlusion culling drop what is below
+			virtual bool            getStyleOpaque() { return _opaque.getBool(); }
+			/// the subtree is rendered into an offscreen layer of the driver and redrawn only when it changes
+			virtual bool            getStyleLayer () { return _layer.getBool(); }
+			
 			Utils::Color _cacheColor = Utils::Color{ 0xFF, 0xFF, 0xFF, 0xFF };
 			virtual Utils::Color    getStyleColor() {
 				if ( _color.readInvalidate() )
@@ -236,26 +363,63 @@ namespace UIMiniEmbed {
 		private:
 			BBox _outerBBox;
 			BBox _innerBBox;
+			/// outer boxes of this node and its render descendants merged, absolute ones may stick out of their parent
+			BBox _subtreeBBox;
+
+			UIResolvedStyle _style;
+
+			void _update_ResolvedStyle() {
+				_style.width     = getStyleWidth();
+				_style.height    = getStyleHeight();
+				_style.padding   = getStylePadding();
+				_style.position  = getStylePosition();
+				_style.gap       = getStyleGap();
+				_style.relative  = getStyleRelative();
+				_style.absolute  = getStyleAbsolute();
+				_style.direction = getStyleDirection();
+				_style.alignX    = getStyleAlignX();
+				_style.alignY    = getStyleAlignY();
+			}
 
 		protected:
-			void setOuterBBox(const BBox& bbox) { 
-				_outerBBox = bbox;
-				
-				const auto padding = getStylePadding();
-				_innerBBox = {
-					_outerBBox.min + Vec2{ padding.left .calc( _outerBBox.getWidth() ), padding.top   .calc( _outerBBox.getHeight() ), },
-					_outerBBox.max - Vec2{ padding.right.calc( _outerBBox.getWidth() ), padding.bottom.calc( _outerBBox.getHeight() ), },
+			const UIResolvedStyle& getResolvedStyleRef() const { return _style; }
+
+			/// true when either box changed
+			bool setOuterBBox(const BBox& bbox) { 
+				const auto& padding = _style.padding;
+				const auto innerBBox = BBox{
+					bbox.min + Vec2{ padding.left .calc( bbox.getWidth() ), padding.top   .calc( bbox.getHeight() ), },
+					bbox.max - Vec2{ padding.right.calc( bbox.getWidth() ), padding.bottom.calc( bbox.getHeight() ), },
 				};
+				
+				if ( _outerBBox == bbox && _innerBBox == innerBBox )
+					return false;
+				
+				_layoutDirty = true;
+				_outerBBox   = bbox;
+				_innerBBox   = innerBBox;
+				return true;
 			}
 			const BBox& getOuterBBoxRef() const { return _outerBBox; }
 			const BBox& getInnerBBoxRef() const { return _innerBBox; }
+			const BBox& getSubtreeBBoxRef() const { return _subtreeBBox; }
+			
+			/// the render children must hold theirs already
+			void _update_SubtreeBBox() {
+				_subtreeBBox = _outerBBox;
+				for(auto& childNode : getChildRenderNodeListRef())
+					_subtreeBBox = _subtreeBBox.merge( childNode->_subtreeBBox );
+			}
 		
 		public:
 			BBox getOuterBBox() const { return _outerBBox; }
 			BBox getInnerBBox() const { return _innerBBox; }
 			
 			void setRootBBox(const BBox& bbox) {
-				setOuterBBox(bbox);
+				if ( setOuterBBox(bbox) ) {
+					_layoutChangeSequence = var_NextSequence();
+					_rootBBoxSequence     = _layoutChangeSequence;
+				}
 			}
 
 			std::string dumpInnerBBox(const int32_t dp = 0) {
@@ -274,13 +438,13 @@ namespace UIMiniEmbed {
 		/////////////////////////////////////////////// CalcPosition
 		
 		private:
-			void _calcSizeAbsolute(const BBox& containerBBox, const UIEnumAlign containerAlignX, const UIEnumAlign containerAlignY) {
+			bool _calcSizeAbsolute(const BBox& containerBBox, const UIEnumAlign containerAlignX, const UIEnumAlign containerAlignY) {
 				const auto size = Vec2{
-					getStyleWidth ().calc( containerBBox.getWidth () ),
-					getStyleHeight().calc( containerBBox.getHeight() ),
+					_style.width .calc( containerBBox.getWidth () ),
+					_style.height.calc( containerBBox.getHeight() ),
 				};
 				
-				const auto position = getStylePosition();
+				const auto& position = _style.position;
 				Vec2 pos = containerBBox.min;
 				
 				bool has_x = false;
@@ -293,7 +457,7 @@ namespace UIMiniEmbed {
 				if ( !has_x ) pos.x += _calcAlignCorrect( containerAlignX, containerBBox.getWidth (), size.x );
 				if ( !has_y ) pos.y += _calcAlignCorrect( containerAlignY, containerBBox.getHeight(), size.y );
 				
-				setOuterBBox( BBox{ pos, pos + size } );
+				return setOuterBBox( BBox{ pos, pos + size } );
 			}
 
 			static BBox _swapSideBBox(const BBox& bbox) {
@@ -309,24 +473,61 @@ namespace UIMiniEmbed {
 				UIEnumAlign firstAlign;
 				UIEnumAlign secondAlign;
 			};
-			TFlowData       _getFlowData(const UIEnumDirection eDir) {
-				const auto  gap = getStyleGap();
+			TFlowData       _getFlowData(const UIEnumDirection eDir) const {
+				const auto& gap        = _style.gap;
 				const auto& innerBBox  = getInnerBBoxRef();
 
 				if ( eDir == UIEnumDirection::Row )
-					return { innerBBox, gap.calc( innerBBox.getWidth() ), getStyleAlignX(), getStyleAlignY() };
+					return { innerBBox, gap.calc( innerBBox.getWidth() ), _style.alignX, _style.alignY };
 
-				return { _swapSideBBox(innerBBox), gap.calc( innerBBox.getHeight() ), getStyleAlignY(), getStyleAlignX() };
+				return { _swapSideBBox(innerBBox), gap.calc( innerBBox.getHeight() ), _style.alignY, _style.alignX };
 			}
-			UIPosValVariant _getFlowSize(const UIEnumDirection eDir) {
+			const UIPosValVariant& _getFlowSize(const UIEnumDirection eDir) const {
 				if ( eDir == UIEnumDirection::Row )
-					return getStyleWidth();
+					return _style.width;
 
-				return getStyleHeight();
+				return _style.height;
 			}
 
 			float _tmpFirstSize = 0;
 			float _tmpSecondSize = 0;
+			
+			/// _layoutDirty: this node must place its children again
+			/// _layoutSubtreeDirty: some render descendant must, walk down without placing
+			bool     _layoutDirty        = true;
+			bool     _layoutSubtreeDirty = true;
+			uint64_t _layoutSequence     = 0;
+			BBox     _layoutRelBBox;
+			
+			/// bumped when this node's render list changes, and the max of that over the render subtree
+			uint64_t _renderListSequence    = 0;
+			uint64_t _renderSubtreeSequence = 0;
+			size_t   _renderSubtreeSize     = 1;
+			/// max of _layoutSequence over the render subtree
+			uint64_t _layoutSubtreeSequence = 0;
+			/// max of _getDrawSequence() over the render subtree
+			uint64_t _drawSubtreeSequence   = 0;
+			/// bumped by update() and setRootBBox() when any box of the tree moved
+			uint64_t _layoutChangeSequence  = 0;
+
+		protected:
+			/// bumped by setRootBBox() when the box moved, UIComponentRoot folds it into its layout sequence
+			uint64_t _rootBBoxSequence      = 0;
+
+		private:
+			
+			bool _update_LayoutSequence() {
+				auto seq = _getLayoutSequence();
+				if ( seq < _bindSequence )
+					seq = _bindSequence;
+				if ( seq == _layoutSequence )
+					return false;
+				
+				_layoutSequence = seq;
+				_layoutDirty    = true;
+				_update_ResolvedStyle();
+				return true;
+			}
 
 			static float _calcAlignCorrect(const UIEnumAlign eAlign, const float containerSize, const float contentSize) {
 				switch( eAlign ) {
@@ -338,8 +539,36 @@ namespace UIMiniEmbed {
 				return 0;
 			}
 
-			void update_PositionWalk(const BBox& parentRelBBox) {
-				const auto  eDir      = getStyleDirection();
+			/// true when any box below changed
+			bool update_PositionWalk(const BBox& parentRelBBox) {
+				if ( _layoutRelBBox != parentRelBBox ) {
+					_layoutRelBBox = parentRelBBox;
+					_layoutDirty   = true;
+				}
+				
+				if ( !_layoutDirty && !_layoutSubtreeDirty )
+					return false;
+				
+				bool changed = false;
+				if ( _layoutDirty )
+					changed = update_PositionChildren(parentRelBBox);
+				
+				const auto& nextRelBBox = _style.relative ? getInnerBBoxRef() : parentRelBBox;
+				for(auto& childNode : getChildRenderNodeListRef())
+					if ( childNode->update_PositionWalk( nextRelBBox ) )
+						changed = true;
+				_update_SubtreeBBox();
+				
+				_layoutDirty        = false;
+				_layoutSubtreeDirty = false;
+				return changed;
+			}
+			
+			/// true when the box of any render child changed
+			bool update_PositionChildren(const BBox& parentRelBBox) {
+				bool changed = false;
+				
+				const auto  eDir      = _style.direction;
 				const auto  eDirInv   = eDir == UIEnumDirection::Row ? UIEnumDirection::Column : UIEnumDirection::Row;
 				const auto& innerBBox = getInnerBBoxRef();
 				const auto  flowData  = _getFlowData( eDir );
@@ -351,7 +580,7 @@ namespace UIMiniEmbed {
 				auto& childRenderNodeListRef = getChildRenderNodeListRef();
 				
 				for(auto& childNode : childRenderNodeListRef) {
-					if ( childNode->getStyleAbsolute() )
+					if ( childNode->_style.absolute )
 						continue;
 					
 					if ( flowNodeIndex != 0 )
@@ -375,7 +604,7 @@ namespace UIMiniEmbed {
 				firstSummaryFr = max(1, firstSummaryFr);
 				float firstFreeSize = max(0, flowData.bbox.getWidth() - firstSummarySize);
 				for(auto& childNode : childRenderNodeListRef) {
-					if ( childNode->getStyleAbsolute() )
+					if ( childNode->_style.absolute )
 						continue;
 					
 					const auto& flowSizeVrnt = childNode->_getFlowSize(eDir);
@@ -388,7 +617,7 @@ namespace UIMiniEmbed {
 				firstSummarySize = 0;
 				float secondMaxSize = 0;
 				for(auto& childNode : childRenderNodeListRef) {
-					if ( childNode->getStyleAbsolute() )
+					if ( childNode->_style.absolute )
 						continue;
 					
 					firstSummarySize += childNode->_tmpFirstSize;
@@ -398,7 +627,7 @@ namespace UIMiniEmbed {
 				float firstPos = _calcAlignCorrect(flowData.firstAlign, flowData.bbox.getWidth(), firstSummarySize);
 				flowNodeIndex = 0;
 				for(auto& childNode : childRenderNodeListRef) {
-					if ( childNode->getStyleAbsolute() )
+					if ( childNode->_style.absolute )
 						continue;
 					
 					float x = firstPos;
@@ -412,28 +641,29 @@ namespace UIMiniEmbed {
 					if ( eDir == UIEnumDirection::Column )
 						outerBBox = _swapSideBBox(outerBBox);
 					
-					childNode->setOuterBBox( BBox{ 
+					if ( childNode->setOuterBBox( BBox{ 
 						innerBBox.min + outerBBox.min,
 						innerBBox.min + outerBBox.max,
-					} );
+					} ) )
+						changed = true;
 					
 					firstPos += childNode->_tmpFirstSize + flowData.gap;
 				}
 				
 				/////////////////////
-				const auto& nextRelBBox = getStyleRelative() ? innerBBox : parentRelBBox;
+				const auto& nextRelBBox = _style.relative ? innerBBox : parentRelBBox;
 
-				const auto alignX = getStyleAlignX();
-				const auto alignY = getStyleAlignY();
+				const auto alignX = _style.alignX;
+				const auto alignY = _style.alignY;
 				for(auto& childNode : childRenderNodeListRef) {
-					if ( !childNode->getStyleAbsolute() )
+					if ( !childNode->_style.absolute )
 						continue;
 					
-					childNode->_calcSizeAbsolute(nextRelBBox, alignX, alignY);
+					if ( childNode->_calcSizeAbsolute(nextRelBBox, alignX, alignY) )
+						changed = true;
 				}
 				
-				for(auto& childNode : childRenderNodeListRef)
-					childNode->update_PositionWalk( nextRelBBox ); 
+				return changed;
 			}
 
 
@@ -444,14 +674,24 @@ namespace UIMiniEmbed {
 		/////////////////////////////////////////////// InputMouse
 		private:
 
-			SP_UIComponent input_MouseSearchHoverFinalWalk(const UIInputMouseState& mouseState) {
+			/// pClip: clip of the ancestors, nothing below can be hit outside it
+			SP_UIComponent input_MouseSearchHoverFinalWalk(const UIInputMouseState& mouseState, const BBox* pClip = nullptr) {
+				if ( pClip && !pClip->isPointOnBBox(mouseState.client) )
+					return nullptr;
+				
 				SP_UIComponent spNode = nullptr;
 				
 				if ( getOuterBBoxRef().isPointOnBBox(mouseState.client) )
 					spNode = shared_from_this();
 
+				BBox clip;
+				if ( getStyleClip() ) {
+					clip  = pClip ? pClip->intersect( getOuterBBoxRef() ) : getOuterBBoxRef();
+					pClip = &clip;
+				}
+				
 				for( auto& renderChildNode : getChildRenderNodeListRef() ) {
-					auto spNode2 = renderChildNode->input_MouseSearchHoverFinalWalk(mouseState);
+					auto spNode2 = renderChildNode->input_MouseSearchHoverFinalWalk(mouseState, pClip);
 					if ( spNode2 )
 						spNode = spNode2;
 				}
@@ -605,13 +845,46 @@ namespace UIMiniEmbed {
 		/////////////////////////////////////////////// Main
 
 		public:
-			virtual bool draw                      (SP_UIRenderDriverApi& api, const UIRenderContext& rCtx) { return true; }
+			/// records this node's own commands, false skips the render children
+			virtual bool draw                      (UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& rCtx) { return true; }
 
 			virtual void _update_ChildNodeList     (UIComponentList& outList, SP_UINodeDesc& spNodeDesc) {}
 			virtual void _update_SelfRenderNodeList(UIComponentList& outList                           ) {}
 			virtual void _update_State() {}
+			/// called on render nodes before their layout sequence is read, e.g. to measure content with the driver
+			virtual void _update_Prepare(const UIUpdateContext& uCtx) {}
 
 		private:
+			/// layer of the driver while the layer style is set, see UIRenderDriverApi::createLayer
+			UIResourceHandle                   _layerHandle   = 0;
+			std::weak_ptr< UIRenderDriverApi > _wpLayerApi;
+			uint32_t                           _layerVersion  = 0;
+			uint64_t                           _layerSequence = 0;
+			BBox                               _layerBBox;
+			UIRenderContext                    _layerRCtx;
+			
+			/// a layer is asked for once per driver, a driver without layers keeps the handle at 0
+			void _update_Layer(const UIUpdateContext& uCtx) {
+				const bool wantLayer  = uCtx.spApi && getStyleLayer();
+				auto       spLayerApi = _wpLayerApi.lock();
+				if ( !spLayerApi )
+					_layerHandle = 0;
+				
+				if ( spLayerApi && ( !wantLayer || spLayerApi != uCtx.spApi ) ) {
+					if ( _layerHandle )
+						spLayerApi->releaseLayer(_layerHandle);
+					_layerHandle = 0;
+					_wpLayerApi.reset();
+					spLayerApi   = nullptr;
+				}
+				
+				if ( wantLayer && !spLayerApi ) {
+					_layerHandle  = uCtx.spApi->createLayer();
+					_layerVersion = 0;
+					_wpLayerApi   = uCtx.spApi;
+				}
+			}
+			
 			void update_ChildNodeListWalk() {
 				_update_State();
 				_update_ChildNodeList( getChildNodeListRef(), _spNodeDesc );
@@ -619,15 +892,50 @@ namespace UIMiniEmbed {
 				for( auto& childNode : getChildNodeListRef() )
 					childNode->update_ChildNodeListWalk();
 			}
-			void update_ChildRenderNodeListWalk() {
+			/// returns true when this node or a render descendant needs layout
+			bool update_ChildRenderNodeListWalk(const UIUpdateContext& uCtx) {
 				auto& childRenderNodeListRef = getChildRenderNodeListRef();
+				_prevChildRenderNodeList.swap(childRenderNodeListRef);
 				childRenderNodeListRef.clear();
 
 				for( auto& childNode : getChildNodeListRef() )
 					childNode->_update_SelfRenderNodeList(childRenderNodeListRef);
 				
-				for( auto& renderChildNode : childRenderNodeListRef )
-					renderChildNode->update_ChildRenderNodeListWalk();
+				if ( (const std::vector< SP_UIComponent >&)childRenderNodeListRef != (const std::vector< SP_UIComponent >&)_prevChildRenderNodeList ) {
+					_layoutDirty        = true;
+					_renderListSequence = var_NextSequence();
+				}
+				_prevChildRenderNodeList.clear();
+				
+				_renderSubtreeSequence = _renderListSequence;
+				_renderSubtreeSize     = 1;
+				_layoutSubtreeSequence = _layoutSequence;
+				_drawSubtreeSequence   = _getDrawSequence();
+				if ( _drawSubtreeSequence < _bindSequence )
+					_drawSubtreeSequence = _bindSequence;
+				
+				bool subtreeDirty = false;
+				for( auto& renderChildNode : childRenderNodeListRef ) {
+					/// a child's size is placed by this node
+					renderChildNode->_update_Layer(uCtx);
+					renderChildNode->_update_Prepare(uCtx);
+					if ( renderChildNode->_update_LayoutSequence() )
+						_layoutDirty = true;
+					
+					if ( renderChildNode->update_ChildRenderNodeListWalk(uCtx) )
+						subtreeDirty = true;
+					
+					if ( _renderSubtreeSequence < renderChildNode->_renderSubtreeSequence )
+						_renderSubtreeSequence = renderChildNode->_renderSubtreeSequence;
+					if ( _layoutSubtreeSequence < renderChildNode->_layoutSubtreeSequence )
+						_layoutSubtreeSequence = renderChildNode->_layoutSubtreeSequence;
+					if ( _drawSubtreeSequence < renderChildNode->_drawSubtreeSequence )
+						_drawSubtreeSequence = renderChildNode->_drawSubtreeSequence;
+					_renderSubtreeSize += renderChildNode->_renderSubtreeSize;
+				}
+				
+				_layoutSubtreeDirty = _layoutSubtreeDirty || subtreeDirty;
+				return _layoutDirty || _layoutSubtreeDirty;
 			}
 			void update_StateWalk() {
 				_update_State();
@@ -636,33 +944,224 @@ namespace UIMiniEmbed {
 					childNode->update_StateWalk();
 			}
 
+			SP_UILayoutEngine _spLayoutEngine = nullptr;
+
 		public:
-			void update() {
+			/// nullptr restores the recursive walk
+			void setLayoutEngine(SP_UILayoutEngine spLayoutEngine) {
+				_spLayoutEngine = spLayoutEngine;
+				if ( _spLayoutEngine )
+					_spLayoutEngine->reset();
+			}
+			
+			void update(const UIUpdateContext& uCtx = {}) {
 				loop_Update();
 				
 				update_ChildNodeListWalk();
-				update_ChildRenderNodeListWalk();
-				update_PositionWalk( getInnerBBoxRef() );
+				_update_Layer(uCtx);
+				_update_Prepare(uCtx);
+				
+				bool changed = false;
+				if ( _update_LayoutSequence() )
+					changed = setOuterBBox( getOuterBBoxRef() );
+				update_ChildRenderNodeListWalk(uCtx);
+				
+				if ( _spLayoutEngine )
+					changed |= _spLayoutEngine->layout(*this);
+				else
+					changed |= update_PositionWalk( getInnerBBoxRef() );
+				
+				if ( changed )
+					_layoutChangeSequence = var_NextSequence();
 				//update_StateWalk();
 			}
 
-			void drawAll(SP_UIRenderDriverApi& api, const UIRenderContext& parentRCtx = {}) {
+		private:
+			/// how the draw walk records a child subtree, UIRecordParallel hands large ones to other threads
+			struct TRecordChildSerial {
+				void operator()(UIComponent& childNode, UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& rCtx, const BBox& viewport, UIDrawStats& stats) const {
+					childNode.draw_RecordWalk(cmdBuffer, rCtx, viewport, stats);
+				}
+			};
+			
+			/// Subtrees that end up fully transparent, or whose subtree box misses viewport or the clip, are skipped whole.
+			/// The subtree box holds descendants placed outside their ancestor's box, those are still drawn.
+			template< class TRecordChild = TRecordChildSerial >
+			void draw_RecordWalk(UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& parentRCtx, const BBox& viewport, UIDrawStats& stats, const TRecordChild& recordChild = {}) {
 				auto color = getStyleColor();
 				const auto opacity = getStyleOpacity();
 				const float finalOpacity = clamp( 0, parentRCtx.opacity * opacity * ( ((float)color.a) / ((float)0xFF) ), 1 );
 				
+				if ( finalOpacity <= 0 ) {
+					stats.culledTransparentCount += _renderSubtreeSize;
+					return;
+				}
+				stats.drawnCount++;
+				
 				color.a = (uint8_t)clamp( 0, finalOpacity * ((float)0xFF), 0xFF );
 				
 				const auto rCtx = UIRenderContext{ 
 					finalOpacity, 
 					color,
+					parentRCtx.clip,
+					parentRCtx.hasClip,
 				};
 				
-				if ( !draw(api, rCtx) )
+				if ( _layerHandle )
+					draw_RecordLayer(cmdBuffer, rCtx, stats);
+				else
+					draw_RecordNode(cmdBuffer, rCtx, viewport, stats, recordChild);
+			}
+			/// this node and its children, rCtx already holds this node's opacity and color
+			template< class TRecordChild = TRecordChildSerial >
+			void draw_RecordNode(UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& nodeRCtx, const BBox& viewport, UIDrawStats& stats, const TRecordChild& recordChild = {}) {
+				auto rCtx = nodeRCtx;
+				
+				const size_t firstCommand   = cmdBuffer.getCommandListRef().size();
+				const bool   drawChildNodes = draw(cmdBuffer, rCtx);
+				if ( rCtx.opacity >= 1 && getStyleOpaque() )
+					cmdBuffer.markOpaque(firstCommand);
+				if ( !drawChildNodes )
 					return;
 				
-				for( auto& childNode : getChildRenderNodeListRef() )
-					childNode->drawAll(api, rCtx);
+				auto drawChildren = [&]() {
+					for( auto& childNode : getChildRenderNodeListRef() ) {
+						const auto& childBBox = childNode->getSubtreeBBoxRef();
+						if ( !viewport.isIntersect(childBBox) || !rCtx.isVisible(childBBox) ) {
+							stats.culledOffscreenCount += childNode->_renderSubtreeSize;
+							continue;
+						}
+						recordChild(*childNode, cmdBuffer, rCtx, viewport, stats);
+					}
+				};
+				
+				if ( !getStyleClip() ) {
+					drawChildren();
+					return;
+				}
+				
+				rCtx.clip    = nodeRCtx.hasClip ? nodeRCtx.clip.intersect( getOuterBBoxRef() ) : getOuterBBoxRef();
+				rCtx.hasClip = true;
+				if ( !rCtx.clip.isValid() )
+					return;
+				
+				cmdBuffer.addClip(rCtx.clip);
+				drawChildren();
+				
+				if ( nodeRCtx.hasClip )
+					cmdBuffer.addClip(nodeRCtx.clip);
+				else
+					cmdBuffer.addClipReset();
+			}
+			/// Renders the subtree into the layer only when something in it changed, then draws the layer.
+			/// Assumes every recording reaches the driver, the layer keeps what the last one rendered.
+			void draw_RecordLayer(UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& rCtx, UIDrawStats& stats) {
+				const auto& bbox = getOuterBBoxRef();
+				
+				auto seq = _drawSubtreeSequence;
+				if ( seq < _renderSubtreeSequence ) seq = _renderSubtreeSequence;
+				if ( seq < _layoutSubtreeSequence ) seq = _layoutSubtreeSequence;
+				
+				const auto layerRCtx = UIRenderContext{ rCtx.opacity, rCtx.color };
+				if ( _layerVersion && seq == _layerSequence && bbox == _layerBBox && layerRCtx == _layerRCtx ) {
+					stats.layerCachedCount += _renderSubtreeSize;
+				} else {
+					_layerVersion++;
+					_layerSequence = seq;
+					_layerBBox     = bbox;
+					_layerRCtx     = layerRCtx;
+					
+					cmdBuffer.addLayerBegin(_layerHandle, bbox);
+					draw_RecordNode(cmdBuffer, layerRCtx, bbox, stats);
+					cmdBuffer.addLayerEnd();
+				}
+				
+				cmdBuffer.addLayer( _layerHandle, _layerVersion, bbox, Utils::Color{ 0xFF, 0xFF, 0xFF, 0xFF } );
+			}
+			
+			/// the last recorded frame and the one before it, which keeps its strings alive for the damage diff
+			SP_UIRenderCommandBuffer _spCommandBuffer     = nullptr;
+			SP_UIRenderCommandBuffer _spPrevCommandBuffer = nullptr;
+			UIRenderDamage           _damage;
+			std::vector< BBox >      _damageList;
+			uint64_t                 _drawListSequence    = 0;
+			UIRenderContext          _drawListRCtx;
+			UIDrawStats              _drawStats;
+			bool                     _drawListValid       = false;
+			bool                     _occlusionCulling    = false;
+			UIRenderOcclusion        _occlusion;
+			SP_UIRecordEngine        _spRecordEngine      = nullptr;
+			
+		public:
+			/// nullptr restores the recursive walk
+			void setRecordEngine(SP_UIRecordEngine spRecordEngine) {
+				_spRecordEngine = spRecordEngine;
+			}
+			
+			/// appends this subtree as drawn below parentRCtx, culled to this node's outer box
+			void recordCommandBuffer(UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& parentRCtx = {}) {
+				_drawStats = UIDrawStats{};
+				if ( _spRecordEngine )
+					_spRecordEngine->record(*this, cmdBuffer, parentRCtx, getOuterBBoxRef(), _drawStats);
+				else
+					draw_RecordWalk(cmdBuffer, parentRCtx, getOuterBBoxRef(), _drawStats);
+			}
+			
+			/// Records the frame as of the last update() into the retained draw list.
+			/// Returns false and leaves the list untouched when no draw var, render list or box changed since
+			/// the previous recording, otherwise records again and fills getDamageListRef().
+			bool recordDrawList(const UIRenderContext& parentRCtx = {}) {
+				auto seq = _drawSubtreeSequence;
+				if ( seq < _renderSubtreeSequence ) seq = _renderSubtreeSequence;
+				if ( seq < _layoutChangeSequence  ) seq = _layoutChangeSequence;
+				
+				if ( _drawListValid && seq == _drawListSequence && parentRCtx == _drawListRCtx ) {
+					_damageList.clear();
+					return false;
+				}
+				
+				if ( !_spCommandBuffer ) {
+					_spCommandBuffer     = std::make_shared< UIRenderCommandBuffer >();
+					_spPrevCommandBuffer = std::make_shared< UIRenderCommandBuffer >();
+				}
+				
+				_spPrevCommandBuffer.swap(_spCommandBuffer);
+				/// still held by the driver, see UIRenderDriverApi::submitFrame
+				if ( _spCommandBuffer.use_count() > 1 )
+					_spCommandBuffer = std::make_shared< UIRenderCommandBuffer >();
+				_spCommandBuffer->clear();
+				recordCommandBuffer(*_spCommandBuffer, parentRCtx);
+				if ( _occlusionCulling )
+					_drawStats.occludedCommandCount = _occlusion.apply(*_spCommandBuffer);
+				_damage.compute(*_spPrevCommandBuffer, *_spCommandBuffer, _damageList);
+				
+				_drawListValid    = true;
+				_drawListSequence = seq;
+				_drawListRCtx     = parentRCtx;
+				return true;
+			}
+			
+			/// drops draws hidden below opaque nodes from the retained draw list, off by default
+			void setOcclusionCulling(const bool enable) {
+				_occlusionCulling = enable;
+				_drawListValid    = false;
+			}
+			
+			/// valid after recordDrawList() or drawAll()
+			const UIRenderCommandBuffer& getDrawListRef  () const { return *_spCommandBuffer; }
+			/// rects that changed in the last recordDrawList(), empty when it returned false
+			const std::vector< BBox >&   getDamageListRef() const { return _damageList;      }
+			/// of the last recording, kept when recordDrawList() reuses the list
+			const UIDrawStats&           getDrawStatsRef () const { return _drawStats;       }
+			
+			/// Submits the retained draw list in one call, true when it was recorded again.
+			/// The list is submitted every frame, also when it was reused, so drivers that clear and redraw
+			/// keep working. A reused list is the same buffer object as last frame, untouched, so a driver
+			/// that only presents compares its identity. Hosts that rather skip the call use recordDrawList().
+			bool drawAll(SP_UIRenderDriverApi& api, const UIRenderContext& parentRCtx = {}) {
+				const bool recorded = recordDrawList(parentRCtx);
+				api->submitFrame(_spCommandBuffer);
+				return recorded;
 			}
 	};
 
@@ -698,6 +1197,12 @@ namespace UIMiniEmbed {
 		public:
 		
 			virtual bool getStyleRelative() override { return true; }
+			/// the size getters read the outer box, so the resolved style goes stale on every host resize
+			virtual uint64_t _getLayoutSequence() override {
+				auto seq = UIComponentContainer::_getLayoutSequence();
+				if ( seq < _rootBBoxSequence ) seq = _rootBBoxSequence;
+				return seq;
+			}
 			virtual UIPosValVariant getStyleWidth () override { return UIPosValVariant{ UIPosValVariant::Pixel, getOuterBBoxRef().getWidth () }; }
 			virtual UIPosValVariant getStyleHeight() override { return UIPosValVariant{ UIPosValVariant::Pixel, getOuterBBoxRef().getHeight() }; }
 
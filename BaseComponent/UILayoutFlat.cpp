@@ -0,0 +1,369 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// Data-oriented layout engine.
+	/// The render tree is flattened breadth first into structure-of-arrays buffers, so the children of a node
+	/// are one contiguous index range and every parent precedes its children. Layout is then one linear sweep,
+	/// with box arithmetic done four lanes at a time. Results match update_PositionWalk bit for bit and are
+	/// written back to _outerBBox / _innerBBox / _subtreeBBox. The flattening is rebuilt only when a render list changes.
+	///
+	///		root->setLayoutEngine( UILayoutFlat::create() );
+	class UILayoutFlat : public UILayoutEngine {
+		private:
+			enum EnumFlag : uint8_t {
+				FlagAbsolute = 1,
+				FlagRelative = 2,
+				FlagColumn   = 4,
+			};
+
+			UIComponent*                    _pRoot             = nullptr;
+			uint64_t                        _structureSequence = 0;
+			uint64_t                        _styleSequence     = 0;
+			bool                            _writeAll          = true;
+
+			/// topology
+			std::vector< UIComponent* >     _nodeList;
+			std::vector< uint32_t >         _parentList;
+			std::vector< uint32_t >         _childFirstList;
+			std::vector< uint32_t >         _childCountList;
+			std::vector< uint32_t >         _nextRelList;
+
+			/// resolved style
+			std::vector< uint8_t >          _flagList;
+			std::vector< UIEnumAlign >      _alignXList;
+			std::vector< UIEnumAlign >      _alignYList;
+			std::vector< UIPosValVariant >  _widthList;
+			std::vector< UIPosValVariant >  _heightList;
+			std::vector< UIPosValVariant >  _gapList;
+			std::vector< UIPosValVariantRect > _positionList;
+			std::vector< UIFloat4 >         _padValueList;	/// { left, top, -right, -bottom }
+			std::vector< UIFloat4 >         _padPercentList;
+			std::vector< UIFloat4 >         _padEnabledList;
+
+			/// output
+			std::vector< BBox >             _outerList;
+			std::vector< BBox >             _innerList;
+			std::vector< BBox >             _subtreeList;
+			std::vector< float >            _firstSizeList;
+			std::vector< float >            _secondSizeList;
+			std::vector< uint8_t >          _changedList;
+
+			void _buildTopology(UIComponent& root) {
+				_pRoot = &root;
+				_structureSequence = root._renderSubtreeSequence;
+
+				_nodeList  .clear();
+				_parentList.clear();
+				_nodeList  .reserve( root._renderSubtreeSize );
+				_parentList.reserve( root._renderSubtreeSize );
+
+				_nodeList  .push_back( &root );
+				_parentList.push_back( 0 );
+
+				_childFirstList.resize( root._renderSubtreeSize );
+				_childCountList.resize( root._renderSubtreeSize );
+				for(size_t i = 0; i < _nodeList.size(); i++) {
+					auto& childRenderNodeListRef = _nodeList[i]->getChildRenderNodeListRef();
+
+					_childFirstList[i] = (uint32_t)_nodeList.size();
+					_childCountList[i] = (uint32_t)childRenderNodeListRef.size();
+
+					for(auto& childNode : childRenderNodeListRef) {
+						_nodeList  .push_back( childNode.get() );
+						_parentList.push_back( (uint32_t)i );
+					}
+
+					if ( _childFirstList.size() < _nodeList.size() ) {
+						_childFirstList.resize( _nodeList.size() );
+						_childCountList.resize( _nodeList.size() );
+					}
+				}
+
+				const size_t count = _nodeList.size();
+				_nextRelList   .resize(count);
+				_flagList      .resize(count);
+				_alignXList    .resize(count);
+				_alignYList    .resize(count);
+				_widthList     .resize(count);
+				_heightList    .resize(count);
+				_gapList       .resize(count);
+				_positionList  .resize(count);
+				_padValueList  .resize(count);
+				_padPercentList.resize(count);
+				_padEnabledList.resize(count);
+				_outerList     .resize(count);
+				_innerList     .resize(count);
+				_subtreeList   .resize(count);
+				_firstSizeList .resize(count);
+				_secondSizeList.resize(count);
+				_changedList   .resize(count);
+				
+				_styleSequence = 0;
+				_writeAll      = true;
+			}
+
+			/// nodes live wherever the allocator put them, fetch ahead of the linear gather and write back
+			static constexpr size_t PrefetchDistance = 8;
+
+			template< class T >
+			void _prefetchNode(const size_t i, T UIComponent::* pMember) const {
+				if ( i < _nodeList.size() )
+					uiPrefetch( &( _nodeList[i]->*pMember ) );
+			}
+
+			void _gatherStyle() {
+				for(size_t i = 0; i < _nodeList.size(); i++) {
+					_prefetchNode( i + PrefetchDistance, &UIComponent::_style );
+					
+					const auto& style = _nodeList[i]->_style;
+
+					_flagList  [i] =
+						( style.absolute ? FlagAbsolute : 0 ) |
+						( style.relative ? FlagRelative : 0 ) |
+						( style.direction == UIEnumDirection::Column ? FlagColumn : 0 );
+					_alignXList  [i] = style.alignX;
+					_alignYList  [i] = style.alignY;
+					_widthList   [i] = style.width;
+					_heightList  [i] = style.height;
+					_gapList     [i] = style.gap;
+					_positionList[i] = style.position;
+
+					const auto& pad = style.padding;
+					_padValueList  [i] = UIFloat4::set( pad.left.getValue(), pad.top.getValue(), -pad.right.getValue(), -pad.bottom.getValue() );
+					_padPercentList[i] = UIFloat4::mask(
+						pad.left .getType() == UIPosValVariant::Percent, pad.top   .getType() == UIPosValVariant::Percent,
+						pad.right.getType() == UIPosValVariant::Percent, pad.bottom.getType() == UIPosValVariant::Percent );
+					_padEnabledList[i] = UIFloat4::mask(
+						_isCalcType(pad.left ), _isCalcType(pad.top   ),
+						_isCalcType(pad.right), _isCalcType(pad.bottom) );
+
+					/// children of i use this node's inner box as their relative container, or inherit the parent's
+					if ( i == 0 || ( _flagList[i] & FlagRelative ) )
+						_nextRelList[i] = (uint32_t)i;
+					else
+						_nextRelList[i] = _nextRelList[ _parentList[i] ];
+				}
+			}
+
+			static bool _isCalcType(const UIPosValVariant& vrnt) {
+				return vrnt.getType() == UIPosValVariant::Pixel || vrnt.getType() == UIPosValVariant::Percent;
+			}
+
+			/// UIComponent::setOuterBBox in four lanes.
+			/// The max lanes add a negated padding, and -0 when padding is off, so signed zeros match "max - pad".
+			void _setOuter(const size_t i, const UIFloat4& outer) {
+				const auto prevOuter = _outerList[i];
+				const auto prevInner = _innerList[i];
+				
+				outer.store( _outerList[i] );
+
+				const auto& bbox  = _outerList[i];
+				const float w     = bbox.getWidth ();
+				const float h     = bbox.getHeight();
+				const auto  pad   = UIFloat4::select( _padPercentList[i], _padValueList[i] * UIFloat4::set(w, h, w, h), _padValueList[i] );
+				const auto  inner = outer + UIFloat4::select( _padEnabledList[i], pad, UIFloat4::set(0.0f, 0.0f, -0.0f, -0.0f) );
+
+				inner.store( _innerList[i] );
+				
+				_changedList[i] = ( prevOuter != _outerList[i] ) || ( prevInner != _innerList[i] );
+			}
+
+			const UIPosValVariant& _getFlowSize(const size_t i, const bool column) const {
+				return column ? _heightList[i] : _widthList[i];
+			}
+
+			void _placeFlow(const size_t p) {
+				const uint32_t first = _childFirstList[p];
+				const uint32_t last  = first + _childCountList[p];
+
+				const bool  column    = ( _flagList[p] & FlagColumn ) != 0;
+				const auto& innerBBox = _innerList[p];
+
+				const auto  flowBBox    = column ? UIComponent::_swapSideBBox(innerBBox) : innerBBox;
+				const float flowGap     = _gapList[p].calc( column ? innerBBox.getHeight() : innerBBox.getWidth() );
+				const auto  firstAlign  = column ? _alignYList[p] : _alignXList[p];
+				const auto  secondAlign = column ? _alignXList[p] : _alignYList[p];
+				const float flowWidth   = flowBBox.getWidth ();
+				const float flowHeight  = flowBBox.getHeight();
+
+				float  firstSummarySize = 0;
+				float  firstSummaryFr   = 0;
+				size_t flowNodeIndex    = 0;
+				for(uint32_t c = first; c < last; c++) {
+					if ( _flagList[c] & FlagAbsolute )
+						continue;
+
+					if ( flowNodeIndex != 0 )
+						firstSummarySize += flowGap;
+					flowNodeIndex++;
+
+					_secondSizeList[c] = _getFlowSize(c, !column).calc( flowHeight );
+
+					const auto& firstSizeVrnt = _getFlowSize(c, column);
+					if ( firstSizeVrnt.isFraction() ) {
+						firstSummaryFr += firstSizeVrnt.getFraction();
+						continue;
+					}
+
+					_firstSizeList[c] = firstSizeVrnt.calc( flowWidth );
+					firstSummarySize += _firstSizeList[c];
+				}
+
+				firstSummaryFr = ( 1 > firstSummaryFr ) ? 1 : firstSummaryFr;
+				const float firstFreeSize = ( 0 > flowWidth - firstSummarySize ) ? 0 : flowWidth - firstSummarySize;
+
+				firstSummarySize = 0;
+				for(uint32_t c = first; c < last; c++) {
+					if ( _flagList[c] & FlagAbsolute )
+						continue;
+
+					const auto& firstSizeVrnt = _getFlowSize(c, column);
+					if ( firstSizeVrnt.isFraction() )
+						_firstSizeList[c] = firstSizeVrnt.getFraction() / firstSummaryFr * firstFreeSize;
+
+					firstSummarySize += _firstSizeList[c];
+				}
+
+				const auto innerMin = UIFloat4::set( innerBBox.min.x, innerBBox.min.y, innerBBox.min.x, innerBBox.min.y );
+
+				float firstPos = UIComponent::_calcAlignCorrect(firstAlign, flowWidth, firstSummarySize);
+				for(uint32_t c = first; c < last; c++) {
+					if ( _flagList[c] & FlagAbsolute )
+						continue;
+
+					const float secondPos = UIComponent::_calcAlignCorrect(secondAlign, flowHeight, _secondSizeList[c]);
+					const float firstEnd  = firstPos  + _firstSizeList [c];
+					const float secondEnd = secondPos + _secondSizeList[c];
+
+					const auto local = column ?
+						UIFloat4::set( secondPos, firstPos, secondEnd, firstEnd ) :
+						UIFloat4::set( firstPos, secondPos, firstEnd, secondEnd );
+
+					_setOuter( c, innerMin + local );
+
+					firstPos += _firstSizeList[c] + flowGap;
+				}
+			}
+
+			/// UIComponent::_calcSizeAbsolute
+			void _placeAbsolute(const size_t p) {
+				const uint32_t first = _childFirstList[p];
+				const uint32_t last  = first + _childCountList[p];
+
+				const auto& containerBBox = _innerList[ _nextRelList[p] ];
+				const float containerW    = containerBBox.getWidth ();
+				const float containerH    = containerBBox.getHeight();
+
+				for(uint32_t c = first; c < last; c++) {
+					if ( !( _flagList[c] & FlagAbsolute ) )
+						continue;
+
+					const auto size = Vec2{ _widthList[c].calc( containerW ), _heightList[c].calc( containerH ) };
+					const auto& position = _positionList[c];
+
+					Vec2 pos = containerBBox.min;
+					bool has_x = false;
+					bool has_y = false;
+					if ( !position.left  .isNone() ) { pos.x = containerBBox.min.x +          position.left  .calc( containerW ); has_x = true; }
+					if ( !position.right .isNone() ) { pos.x = containerBBox.max.x - size.x - position.right .calc( containerW ); has_x = true; }
+					if ( !position.top   .isNone() ) { pos.y = containerBBox.min.y +          position.top   .calc( containerH ); has_y = true; }
+					if ( !position.bottom.isNone() ) { pos.y = containerBBox.max.y - size.y - position.bottom.calc( containerH ); has_y = true; }
+
+					if ( !has_x ) pos.x += UIComponent::_calcAlignCorrect( _alignXList[p], containerW, size.x );
+					if ( !has_y ) pos.y += UIComponent::_calcAlignCorrect( _alignYList[p], containerH, size.y );
+
+					_setOuter( c, UIFloat4::set( pos.x, pos.y, pos.x + size.x, pos.y + size.y ) );
+				}
+			}
+
+			/// UIComponent::_update_SubtreeBBox, children follow their parent so one backward sweep merges every subtree.
+			/// Only boxes that changed are stored.
+			void _mergeSubtree() {
+				for(size_t i = _nodeList.size(); i-- > 0; ) {
+					const uint32_t first = _childFirstList[i];
+					const uint32_t last  = first + _childCountList[i];
+
+					auto bbox = _outerList[i];
+					for(uint32_t c = first; c < last; c++)
+						bbox = bbox.merge( _subtreeList[c] );
+
+					if ( !_writeAll && bbox == _subtreeList[i] )
+						continue;
+
+					_subtreeList[i] = bbox;
+					_nodeList[i]->_subtreeBBox = bbox;
+				}
+			}
+
+			/// Only boxes that moved are stored, untouched nodes are never brought into cache.
+			/// Per-node dirty flags are not maintained by this engine, reset() makes the next run write everything.
+			bool _writeBack() {
+				bool changed = _writeAll;
+				for(size_t i = 0; i < _nodeList.size(); i++) {
+					if ( !_writeAll && !_changedList[i] )
+						continue;
+					
+					changed = true;
+					_prefetchNode( i + PrefetchDistance, &UIComponent::_outerBBox );
+					
+					auto pNode = _nodeList[i];
+					pNode->_outerBBox = _outerList[i];
+					pNode->_innerBBox = _innerList[i];
+				}
+				
+				_writeAll = false;
+				return changed;
+			}
+
+		public:
+			/// Layout reads only the render structure, the resolved styles and the root box,
+			/// so the per-node dirty flags are not needed to decide whether to run.
+			virtual bool layout(UIComponent& root) override {
+				bool dirty = false;
+				
+				if ( _pRoot != &root || _structureSequence != root._renderSubtreeSequence || _nodeList.empty() ) {
+					_buildTopology(root);
+					dirty = true;
+				}
+
+				if ( _styleSequence != root._layoutSubtreeSequence ) {
+					_styleSequence = root._layoutSubtreeSequence;
+					_gatherStyle();
+					dirty = true;
+				}
+
+				if ( _outerList[0] != root._outerBBox || _innerList[0] != root._innerBBox )
+					dirty = true;
+				
+				if ( !dirty )
+					return false;
+
+				_outerList[0] = root._outerBBox;
+				_innerList[0] = root._innerBBox;
+
+				for(size_t i = 0; i < _nodeList.size(); i++) {
+					if ( !_childCountList[i] )
+						continue;
+
+					_placeFlow(i);
+					_placeAbsolute(i);
+				}
+
+				_mergeSubtree();
+				return _writeBack();
+			}
+			
+			virtual void reset() override {
+				_nodeList.clear();
+			}
+
+			size_t getNodeCount() const { return _nodeList.size(); }
+
+			static std::shared_ptr< UILayoutFlat > create() {
+				return std::make_shared< UILayoutFlat >();
+			}
+	};
+	using SP_UILayoutFlat = std::shared_ptr< UILayoutFlat >;
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// update_PositionWalk on a UIWorkPool.
+	/// Once a node has placed its children, their subtrees only write their own descendants, so every
+	/// child subtree of at least spawnThreshold render nodes becomes a task, and smaller ones are walked
+	/// inline. Each node runs the same update_PositionChildren as the serial walk, so results are identical.
+	/// Subtree boxes of the nodes that spawned are merged once every task is done.
+	///
+	///		root->setLayoutEngine( UILayoutParallel::create( UIWorkPool::create(4) ) );
+	class UILayoutParallel : public UILayoutEngine {
+		private:
+			SP_UIWorkPool       _spPool;
+			size_t              _spawnThreshold;
+			UIWorkGroup         _group;
+			std::atomic< bool > _changed{ false };
+			/// nodes placed by _walk, each before its descendants
+			std::mutex                  _walkedMutex;
+			std::vector< UIComponent* > _walkedList;
+
+			bool _walk(UIComponent& node, const BBox& parentRelBBox) {
+				if ( node._layoutRelBBox != parentRelBBox ) {
+					node._layoutRelBBox = parentRelBBox;
+					node._layoutDirty   = true;
+				}
+
+				if ( !node._layoutDirty && !node._layoutSubtreeDirty )
+					return false;
+
+				{
+					std::lock_guard< std::mutex > lock(_walkedMutex);
+					_walkedList.push_back(&node);
+				}
+
+				bool changed = false;
+				if ( node._layoutDirty )
+					changed = node.update_PositionChildren(parentRelBBox);
+
+				const auto& nextRelBBox = node._style.relative ? node.getInnerBBoxRef() : parentRelBBox;
+				for(auto& childNode : node.getChildRenderNodeListRef()) {
+					auto* pChildNode = childNode.get();
+					if ( pChildNode->_renderSubtreeSize < _spawnThreshold ) {
+						if ( pChildNode->update_PositionWalk( nextRelBBox ) )
+							changed = true;
+						continue;
+					}
+
+					/// nextRelBBox is a box of an ancestor, it is not written again during this layout
+					const auto* pNextRelBBox = &nextRelBBox;
+					_spPool->run( _group, [this, pChildNode, pNextRelBBox]() {
+						if ( _walk( *pChildNode, *pNextRelBBox ) )
+							_changed.store(true, std::memory_order_relaxed);
+					} );
+				}
+
+				node._layoutDirty        = false;
+				node._layoutSubtreeDirty = false;
+				return changed;
+			}
+
+		public:
+			UILayoutParallel(SP_UIWorkPool spPool, const size_t spawnThreshold) : _spPool(spPool), _spawnThreshold(spawnThreshold) {}
+
+			bool layout(UIComponent& root) override {
+				_changed = false;
+				_walkedList.clear();
+				const bool changed = _walk( root, root.getInnerBBoxRef() );
+				_spPool->wait( _group );
+
+				for(auto it = _walkedList.rbegin(); it != _walkedList.rend(); it++)
+					(*it)->_update_SubtreeBBox();
+
+				return changed || _changed.load();
+			}
+
+			static std::shared_ptr< UILayoutParallel > create(SP_UIWorkPool spPool, const size_t spawnThreshold = 2048) {
+				return std::make_shared< UILayoutParallel >(spPool, spawnThreshold);
+			}
+	};
+	using SP_UILayoutParallel = std::shared_ptr< UILayoutParallel >;
+
+}
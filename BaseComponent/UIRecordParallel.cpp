@@ -0,0 +1,91 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// The draw walk of recordCommandBuffer on a UIWorkPool.
+	/// Every child subtree of at least spawnThreshold render nodes is recorded by a task into a buffer of
+	/// its own, and the walk notes where that buffer goes in its parent's. Once all tasks ran the buffers
+	/// are stitched together in that order, so the commands and painter's order equal the serial walk.
+	/// Layers are recorded on the thread that reaches them.
+	/// With one core the tasks and the stitch only cost time, a few percent over the serial walk, so leave
+	/// the engine unset there.
+	///
+	///		root->setRecordEngine( UIRecordParallel::create( UIWorkPool::create(4) ) );
+	class UIRecordParallel : public UIRecordEngine {
+		private:
+			struct TSegment {
+				UIRenderCommandBuffer cmdBuffer;
+				UIDrawStats           stats;
+				/// child segments in walk order, each goes in before command `first` of cmdBuffer
+				std::vector< std::pair< size_t, std::unique_ptr< TSegment > > > spliceList;
+			};
+
+			/// spliceList is only written by the thread recording its segment
+			struct TRecordChild {
+				UIRecordParallel* pEngine;
+				TSegment*         pSegment;
+
+				void operator()(UIComponent& childNode, UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& rCtx, const BBox& viewport, UIDrawStats& stats) const {
+					if ( childNode._renderSubtreeSize < pEngine->_spawnThreshold ) {
+						childNode.draw_RecordWalk(cmdBuffer, rCtx, viewport, stats);
+						return;
+					}
+
+					pSegment->spliceList.emplace_back( cmdBuffer.getCommandListRef().size(), std::make_unique< TSegment >() );
+					auto* pChildSegment = pSegment->spliceList.back().second.get();
+					auto* pChildNode    = &childNode;
+					auto* pEngine       = this->pEngine;
+					pEngine->_spPool->run( pEngine->_group, [pEngine, pChildNode, pChildSegment, rCtx, viewport]() {
+						pChildNode->draw_RecordWalk( pChildSegment->cmdBuffer, rCtx, viewport, pChildSegment->stats, TRecordChild{ pEngine, pChildSegment } );
+					} );
+				}
+			};
+
+			SP_UIWorkPool _spPool;
+			size_t        _spawnThreshold;
+			UIWorkGroup   _group;
+
+			static void _addStats(UIDrawStats& stats, const UIDrawStats& other) {
+				stats.drawnCount             += other.drawnCount;
+				stats.culledTransparentCount += other.culledTransparentCount;
+				stats.culledOffscreenCount   += other.culledOffscreenCount;
+				stats.layerCachedCount       += other.layerCachedCount;
+			}
+
+			static void _stitch(TSegment& segment, UIRenderCommandBuffer& cmdBuffer, UIDrawStats& stats) {
+				std::vector< uint32_t > stringMap;
+				cmdBuffer.mapStrings(segment.cmdBuffer, stringMap);
+				_addStats(stats, segment.stats);
+
+				size_t first = 0;
+				for(auto& splice : segment.spliceList) {
+					cmdBuffer.append(segment.cmdBuffer, stringMap, first, splice.first);
+					_stitch(*splice.second, cmdBuffer, stats);
+					first = splice.first;
+				}
+				cmdBuffer.append(segment.cmdBuffer, stringMap, first, segment.cmdBuffer.getCommandListRef().size());
+			}
+
+		public:
+			UIRecordParallel(SP_UIWorkPool spPool, const size_t spawnThreshold) : _spPool(spPool), _spawnThreshold(spawnThreshold) {}
+
+			void record(UIComponent& root, UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& parentRCtx, const BBox& viewport, UIDrawStats& stats) override {
+				/// too small to split, nothing to stitch
+				if ( root._renderSubtreeSize < _spawnThreshold * 2 ) {
+					root.draw_RecordWalk(cmdBuffer, parentRCtx, viewport, stats);
+					return;
+				}
+
+				TSegment segment;
+				root.draw_RecordWalk( segment.cmdBuffer, parentRCtx, viewport, segment.stats, TRecordChild{ this, &segment } );
+				_spPool->wait( _group );
+				_stitch(segment, cmdBuffer, stats);
+			}
+
+			static std::shared_ptr< UIRecordParallel > create(SP_UIWorkPool spPool, const size_t spawnThreshold = 2048) {
+				return std::make_shared< UIRecordParallel >(spPool, spawnThreshold);
+			}
+	};
+	using SP_UIRecordParallel = std::shared_ptr< UIRecordParallel >;
+
+}
@@ -66,6 +66,32 @@ namespace UIMiniEmbed {
 			}
 	};
 
+	/// cmp operator of Cmp and CmpI32, compared against interned constants
+	enum class UIEnumCmp {
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+	};
+
+	inline UIEnumCmp parseUIEnumCmp(const UIVar& var) {
+		static const UIString sNotEqual     ("!=");
+		static const UIString sLess         ("<");
+		static const UIString sLessEqual    ("<=");
+		static const UIString sGreater      ("> ");
+		static const UIString sGreaterEqual (">=");
+
+		const auto value = var.getUIString();
+		if ( value == sNotEqual     ) return UIEnumCmp::NotEqual;
+		if ( value == sLess         ) return UIEnumCmp::Less;
+		if ( value == sLessEqual    ) return UIEnumCmp::LessEqual;
+		if ( value == sGreater      ) return UIEnumCmp::Greater;
+		if ( value == sGreaterEqual ) return UIEnumCmp::GreaterEqual;
+		return UIEnumCmp::Equal;
+	}
+
 	class UIComponent_Cmp : public UIComponentContainerTransparent {
 		private:	
 			UIVar _in1;
@@ -73,16 +99,7 @@ namespace UIMiniEmbed {
 			UIVar _cmp;
 			UIVar _out;
 			
-			enum EnumCmpState {
-				Equal,
-				NotEqual,
-				Less,
-				LessEqual,
-				Greater,
-				GreaterEqual,
-			};
-			
-			EnumCmpState _cmpState = Equal;
+			UIEnumCmp _cmpState = UIEnumCmp::Equal;
 		
 		protected:
 			virtual void _init_VarLink() override {
@@ -93,23 +110,17 @@ namespace UIMiniEmbed {
 			}
 			
 			virtual void _update_State() override {
-				if ( _cmp.readInvalidate() ) {
-					_cmpState = Equal;
-					if ( _cmp.getString() == "!=" ) _cmpState = NotEqual;
-					if ( _cmp.getString() == "<"  ) _cmpState = Less;
-					if ( _cmp.getString() == "<=" ) _cmpState = LessEqual;
-					if ( _cmp.getString() == "> " ) _cmpState = Greater;
-					if ( _cmp.getString() == ">=" ) _cmpState = GreaterEqual;
-				}
+				if ( _cmp.readInvalidate() )
+					_cmpState = parseUIEnumCmp(_cmp);
 			
 				switch( _cmpState ) {
-					case Equal   : _out.setBool(  _in1.compare(_in2) ); break;
-					case NotEqual: _out.setBool( !_in1.compare(_in2) ); break;
+					case UIEnumCmp::Equal   : _out.setBool(  _in1.compare(_in2) ); break;
+					case UIEnumCmp::NotEqual: _out.setBool( !_in1.compare(_in2) ); break;
 					
-					case Less        : _out.setBool( _in1.getFloat() <  _in2.getFloat() ); break;
-					case LessEqual   : _out.setBool( _in1.getFloat() <= _in2.getFloat() ); break;
-					case Greater     : _out.setBool( _in1.getFloat() >  _in2.getFloat() ); break;
-					case GreaterEqual: _out.setBool( _in1.getFloat() >= _in2.getFloat() ); break;
+					case UIEnumCmp::Less        : _out.setBool( _in1.getFloat() <  _in2.getFloat() ); break;
+					case UIEnumCmp::LessEqual   : _out.setBool( _in1.getFloat() <= _in2.getFloat() ); break;
+					case UIEnumCmp::Greater     : _out.setBool( _in1.getFloat() >  _in2.getFloat() ); break;
+					case UIEnumCmp::GreaterEqual: _out.setBool( _in1.getFloat() >= _in2.getFloat() ); break;
 				}
 			}
 	};
@@ -121,16 +132,7 @@ namespace UIMiniEmbed {
 			UIVar _cmp;
 			UIVar _out;
 			
-			enum EnumCmpState {
-				Equal,
-				NotEqual,
-				Less,
-				LessEqual,
-				Greater,
-				GreaterEqual,
-			};
-			
-			EnumCmpState _cmpState = Equal;
+			UIEnumCmp _cmpState = UIEnumCmp::Equal;
 		
 		protected:
 			virtual void _init_VarLink() override {
@@ -141,23 +143,17 @@ namespace UIMiniEmbed {
 			}
 			
 			virtual void _update_State() override {
-				if ( _cmp.readInvalidate() ) {
-					_cmpState = Equal;
-					if ( _cmp.getString() == "!=" ) _cmpState = NotEqual;
-					if ( _cmp.getString() == "<"  ) _cmpState = Less;
-					if ( _cmp.getString() == "<=" ) _cmpState = LessEqual;
-					if ( _cmp.getString() == "> " ) _cmpState = Greater;
-					if ( _cmp.getString() == ">=" ) _cmpState = GreaterEqual;
-				}
+				if ( _cmp.readInvalidate() )
+					_cmpState = parseUIEnumCmp(_cmp);
 			
 				switch( _cmpState ) {
-					case Equal   : _out.setBool( _in1.getI32() == _in2.getI32() ); break;
-					case NotEqual: _out.setBool( _in1.getI32() != _in2.getI32() ); break;
+					case UIEnumCmp::Equal   : _out.setBool( _in1.getI32() == _in2.getI32() ); break;
+					case UIEnumCmp::NotEqual: _out.setBool( _in1.getI32() != _in2.getI32() ); break;
 					
-					case Less        : _out.setBool( _in1.getI32() <  _in2.getI32() ); break;
-					case LessEqual   : _out.setBool( _in1.getI32() <= _in2.getI32() ); break;
-					case Greater     : _out.setBool( _in1.getI32() >  _in2.getI32() ); break;
-					case GreaterEqual: _out.setBool( _in1.getI32() >= _in2.getI32() ); break;
+					case UIEnumCmp::Less        : _out.setBool( _in1.getI32() <  _in2.getI32() ); break;
+					case UIEnumCmp::LessEqual   : _out.setBool( _in1.getI32() <= _in2.getI32() ); break;
+					case UIEnumCmp::Greater     : _out.setBool( _in1.getI32() >  _in2.getI32() ); break;
+					case UIEnumCmp::GreaterEqual: _out.setBool( _in1.getI32() >= _in2.getI32() ); break;
 				}
 			}
 	};
@@ -177,7 +173,9 @@ namespace UIMiniEmbed {
 				//if ( !_in.readInvalidate() && !_out.readInvalidate() )
 				//	return;
 				
-				_out.setValue(_in);
+				/// an unconditional copy would invalidate $out, and everything laid out from it, every frame
+				if ( !_out.compare(_in) )
+					_out.setValue(_in);
 			}
 	};
 	
@@ -202,6 +200,10 @@ namespace UIMiniEmbed {
 			bool _once = true;
 
 		protected:
+			virtual void _init_VarLink() override {
+				_once = true;
+			}
+
 			virtual void _update_ChildNodeList(UIComponentList& outList,  SP_UINodeDesc& spNodeDesc) override {
 				outList.clear();
 				
@@ -291,6 +293,7 @@ namespace UIMiniEmbed {
 				_delay = getVar("delay");
 				
 				_startTime = loop_GetTime();
+				_work      = true;
 			}
 
 			virtual void _update_State() override {
@@ -2,6 +2,43 @@
 
 namespace UIMiniEmbed {
 
+	/// path var -> driver handle, resolved again only when the var is invalidated or the driver or atlas map changes.
+	/// A path packed into an atlas resolves to the atlas, and getSrcBBox moves source boxes into it.
+	struct UISpriteResource {
+		UIString                  path;
+		UIResourceHandle          handle    = 0;
+		const UIRenderDriverApi*  pApi      = nullptr;
+		const UISpriteAtlasMap*   pAtlasMap = nullptr;
+		/// the region of the original path while path is an atlas
+		UISpriteAtlasEntry        atlas;
+		bool                      isAtlas   = false;
+		/// bumped whenever path and handle are set again
+		uint64_t                  sequence  = 0;
+		
+		void update(UIVar& pathVar, const UIUpdateContext& uCtx) {
+			const bool pathChanged = pathVar.readInvalidate();
+			if ( !pathChanged && pApi == uCtx.spApi.get() && pAtlasMap == uCtx.spAtlasMap.get() )
+				return;
+			
+			path      = pathVar.getUIString();
+			pAtlasMap = uCtx.spAtlasMap.get();
+			const auto* pAtlas = pAtlasMap ? pAtlasMap->find(path) : nullptr;
+			isAtlas   = pAtlas != nullptr;
+			if ( isAtlas ) {
+				atlas = *pAtlas;
+				path  = atlas.atlas;
+			}
+			
+			pApi     = uCtx.spApi.get();
+			handle   = uCtx.spApi ? uCtx.spApi->resolveResource(path) : 0;
+			sequence = var_NextSequence();
+		}
+		
+		BBox getSrcBBox(const BBox& srcBBox) const {
+			return isAtlas ? atlas.remap(srcBBox) : srcBBox;
+		}
+	};
+
 	class UIComponent_Sprite : public UIComponentContainer {
 		private:	
 			UIVar _path;
@@ -10,6 +47,8 @@ namespace UIMiniEmbed {
 			UIVar _sw;
 			UIVar _sh;
 			
+			UISpriteResource _resource;
+			
 		protected:
 			virtual void _init_VarLink() override {
 				UIComponentContainer::_init_VarLink();
@@ -21,15 +60,24 @@ namespace UIMiniEmbed {
 				_sh   = getVar("sh");
 			}
 			
-			virtual bool draw(SP_UIRenderDriverApi& spApi, const UIRenderContext& rCtx) override {
+			virtual void _update_Prepare(const UIUpdateContext& uCtx) override {
+				_resource.update(_path, uCtx);
+			}
+			
+			virtual uint64_t _getDrawSequence() override {
+				const auto baseSeq = UIComponentContainer::_getDrawSequence();
+				const auto varSeq  = _getMaxSequence( _sx, _sy, _sw, _sh );
+				const auto seq     = ( varSeq < baseSeq ) ? baseSeq : varSeq;
+				return ( seq < _resource.sequence ) ? _resource.sequence : seq;
+			}
+			
+			virtual bool draw(UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& rCtx) override {
 				const auto& innerBBox = getInnerBBoxRef();
 
-				auto srcBBox = BBox{
-					{ _sx.getFloat(), _sw.getFloat() },
-					{ _sy.getFloat(), _sh.getFloat() },
-				};
+				const auto srcPos  = Vec2{ _sx.getFloat(), _sy.getFloat() };
+				const auto srcBBox = BBox{ srcPos, srcPos + Vec2{ _sw.getFloat(), _sh.getFloat() } };
 
-				spApi->drawSprite(_path.getString(), srcBBox, innerBBox, rCtx.color);
+				cmdBuffer.addSprite(_resource.path, _resource.handle, _resource.getSrcBBox(srcBBox), innerBBox, rCtx.color);
 				return true;
 			}
 	};
@@ -48,6 +96,8 @@ namespace UIMiniEmbed {
 			UIVar _endFrame;
 			UIVar _fraction;
 			
+			UISpriteResource _resource;
+			
 		protected:
 			virtual void _init_VarLink() override {
 				UIComponentContainer::_init_VarLink();
@@ -65,7 +115,18 @@ namespace UIMiniEmbed {
 				_fraction   = getVar("fraction");
 			}
 			
-			virtual bool draw(SP_UIRenderDriverApi& spApi, const UIRenderContext& rCtx) override {
+			virtual void _update_Prepare(const UIUpdateContext& uCtx) override {
+				_resource.update(_path, uCtx);
+			}
+			
+			virtual uint64_t _getDrawSequence() override {
+				const auto baseSeq = UIComponentContainer::_getDrawSequence();
+				const auto varSeq  = _getMaxSequence( _tw, _th, _sw, _sh, _startFrame, _endFrame, _fraction );
+				const auto seq     = ( varSeq < baseSeq ) ? baseSeq : varSeq;
+				return ( seq < _resource.sequence ) ? _resource.sequence : seq;
+			}
+			
+			virtual bool draw(UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& rCtx) override {
 				const float fraction = clamp(0, _fraction.getFloat(), 1);
 				
 				const int32_t startFrame = _startFrame.getI32();
@@ -90,7 +151,7 @@ namespace UIMiniEmbed {
 				
 				const auto& innerBBox = getInnerBBoxRef();
 
-				spApi->drawSprite(_path.getString(), srcBBox, innerBBox, rCtx.color);
+				cmdBuffer.addSprite(_resource.path, _resource.handle, _resource.getSrcBBox(srcBBox), innerBBox, rCtx.color);
 				return true;
 			}
 	};
@@ -0,0 +1,173 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// Word wrapped text, broken at spaces to the inner width and at '\n', drawn as one text block command.
+	/// Lines are broken again only when the text, scale, char metrics, inner width or driver change.
+	/// Without w nothing wraps. Without h the height follows the line count, one frame after a resize.
+	///
+	///		TextBlock w=240px text=$questText scale=1
+	class UIComponent_TextBlock : public UIComponentContainer {
+		private:
+			UIVar _text;
+			UIVar _scale;
+			UIVar _charWidth;
+			UIVar _charHeight;
+
+			static constexpr float CharWidth  = 7;
+			static constexpr float CharHeight = 11;
+
+			/// the broken lines joined by '\n', words are measured without interning them
+			UIString                 _blockText;
+			size_t                   _lineCount  = 0;
+			float                    _lineHeight = 0;
+			Vec2                     _measureSize;
+
+			uint64_t                 _breakVarSequence = 0;
+			float                    _breakWidth       = 0;
+			const UIRenderDriverApi* _pBreakApi        = nullptr;
+			bool                     _breakValid       = false;
+			uint64_t                 _measureSequence  = 0;
+			uint64_t                 _linesSequence    = 0;
+
+			static float _getFloatOrDef(const UIVar& var, const float def) {
+				if ( var.isNull() )
+					return def;
+				return max(0, var.getFloat());
+			}
+
+			Vec2 _measure(const UIUpdateContext& uCtx, const std::string& str, const float scale) {
+				Vec2 size;
+				if ( uCtx.spApi && uCtx.spApi->measureText( str, scale, size ) )
+					return size;
+
+				return Vec2{
+					_getFloatOrDef(_charWidth , CharWidth ) * scale * str.length(),
+					_getFloatOrDef(_charHeight, CharHeight) * scale,
+				};
+			}
+
+			void _breakLines(const UIUpdateContext& uCtx, const bool wrap, const float width) {
+				const float scale      = _getFloatOrDef(_scale, 1);
+				const auto  spaceSize  = _measure(uCtx, " ", scale);
+				const auto& text       = _text.getStringRef();
+
+				_lineCount     = 0;
+				_lineHeight    = spaceSize.y;
+				_linesSequence = var_NextSequence();
+
+				float       maxWidth  = 0;
+				float       lineWidth = 0;
+				std::string block;
+				std::string line;
+				auto flush = [&]() {
+					if ( _lineCount++ )
+						block += '\n';
+					block    += line;
+					maxWidth  = max(maxWidth, lineWidth);
+					lineWidth = 0;
+					line.clear();
+				};
+
+				size_t begin = 0;
+				while( true ) {
+					const size_t end       = text.find('\n', begin);
+					const auto   paragraph = std::string_view(text).substr( begin, end == std::string::npos ? std::string::npos : end - begin );
+
+					size_t wordBegin = 0;
+					while( wordBegin < paragraph.size() ) {
+						size_t wordEnd = paragraph.find(' ', wordBegin);
+						if ( wordEnd == std::string_view::npos )
+							wordEnd = paragraph.size();
+
+						if ( wordEnd > wordBegin ) {
+							const auto  word      = std::string( paragraph.substr(wordBegin, wordEnd - wordBegin) );
+							const float wordWidth = _measure(uCtx, word, scale).x;
+
+							if ( wrap && line.size() && lineWidth + spaceSize.x + wordWidth > width )
+								flush();
+
+							if ( line.size() ) {
+								line      += ' ';
+								lineWidth += spaceSize.x;
+							}
+							line      += word;
+							lineWidth += wordWidth;
+						}
+
+						wordBegin = wordEnd + 1;
+					}
+					flush();
+
+					if ( end == std::string::npos )
+						break;
+					begin = end + 1;
+				}
+
+				_blockText = UIString(block);
+
+				const auto size = Vec2{ maxWidth, _lineHeight * _lineCount };
+				if ( size != _measureSize || !_measureSequence ) {
+					_measureSize     = size;
+					_measureSequence = var_NextSequence();
+				}
+			}
+
+		protected:
+			virtual void _init_VarLink() override {
+				UIComponentContainer::_init_VarLink();
+
+				_text       = getVar("text");
+				_scale      = getVar("scale");
+				_charWidth  = getVar("charWidth");
+				_charHeight = getVar("charHeight");
+			}
+
+			virtual void _update_Prepare(const UIUpdateContext& uCtx) override {
+				const auto  varSeq = _getMaxSequence( _text, _scale, _charWidth, _charHeight );
+				const bool  wrap   = !UIComponentContainer::getStyleWidth().isNone();
+				const float width  = wrap ? getInnerBBoxRef().getWidth() : 0;
+				if ( _breakValid && _breakVarSequence == varSeq && _breakWidth == width && _pBreakApi == uCtx.spApi.get() )
+					return;
+
+				_breakValid       = true;
+				_breakVarSequence = varSeq;
+				_breakWidth       = width;
+				_pBreakApi        = uCtx.spApi.get();
+
+				_breakLines(uCtx, wrap, width);
+			}
+
+			virtual uint64_t _getLayoutSequence() override {
+				const auto baseSeq = UIComponentContainer::_getLayoutSequence();
+				return ( _measureSequence < baseSeq ) ? baseSeq : _measureSequence;
+			}
+
+			virtual uint64_t _getDrawSequence() override {
+				/// scale changes break the lines again
+				const auto baseSeq = UIComponentContainer::_getDrawSequence();
+				return ( _linesSequence < baseSeq ) ? baseSeq : _linesSequence;
+			}
+
+			virtual UIPosValVariant getStyleWidth () override {
+				const auto width = UIComponentContainer::getStyleWidth();
+				return width.isNone() ? UIPosValVariant{ UIPosValVariant::Pixel, _measureSize.x } : width;
+			}
+			virtual UIPosValVariant getStyleHeight() override {
+				const auto height = UIComponentContainer::getStyleHeight();
+				return height.isNone() ? UIPosValVariant{ UIPosValVariant::Pixel, _measureSize.y } : height;
+			}
+
+			virtual bool draw(UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& rCtx) override {
+				/// lines past a fixed h still draw, the box covers them for damage and culling
+				const auto& innerBBox = getInnerBBoxRef();
+				const auto  blockBBox = BBox{ innerBBox.min, Vec2{ innerBBox.max.x, max( innerBBox.max.y, innerBBox.min.y + _lineHeight * _lineCount ) } };
+				cmdBuffer.addTextBlock( _blockText, blockBBox, _lineHeight, _getFloatOrDef(_scale, 1), rCtx.color );
+				return true;
+			}
+
+		public:
+			size_t getLineCount() const { return _lineCount; }
+	};
+
+}
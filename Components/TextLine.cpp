@@ -9,6 +9,15 @@ namespace UIMiniEmbed {
 			UIVar _charWidth;
 			UIVar _charHeight;
 			
+			UIString _cacheText;
+			
+			/// measured size, refreshed in _update_Prepare when a var it depends on or the driver changes
+			Vec2                     _measureSize;
+			uint64_t                 _measureVarSequence = 0;
+			const UIRenderDriverApi* _pMeasureApi        = nullptr;
+			bool                     _measureValid       = false;
+			uint64_t                 _measureSequence    = 0;
+			
 			static constexpr float CharWidth  = 7;
 			static constexpr float CharHeight = 11;
 			
@@ -28,19 +37,52 @@ namespace UIMiniEmbed {
 				_charHeight = getVar("charHeight");
 			}
 
-			virtual UIPosValVariant     getStyleWidth () override {
-				return UIPosValVariant{ UIPosValVariant::Pixel, 
-					_getFloatOrDef(_charWidth , CharWidth ) * _getFloatOrDef(_scale, 1) * _text.getStringRef().length() };
+			virtual void _update_Prepare(const UIUpdateContext& uCtx) override {
+				const auto varSeq = _getMaxSequence( _text, _scale, _charWidth, _charHeight );
+				if ( _measureValid && _measureVarSequence == varSeq && _pMeasureApi == uCtx.spApi.get() )
+					return;
+				
+				_measureValid       = true;
+				_measureVarSequence = varSeq;
+				_pMeasureApi        = uCtx.spApi.get();
+				
+				const float scale = _getFloatOrDef(_scale, 1);
+				
+				Vec2 size;
+				if ( !uCtx.spApi || !uCtx.spApi->measureText( _text.getUIString(), scale, size ) )
+					size = Vec2{
+						_getFloatOrDef(_charWidth , CharWidth ) * scale * _text.getStringRef().length(),
+						_getFloatOrDef(_charHeight, CharHeight) * scale,
+					};
+				
+				/// a new text of the same size does not move anything
+				if ( size != _measureSize || !_measureSequence ) {
+					_measureSize     = size;
+					_measureSequence = var_NextSequence();
+				}
 			}
-			virtual UIPosValVariant     getStyleHeight() override {
-				return UIPosValVariant{ UIPosValVariant::Pixel, 
-					_getFloatOrDef(_charHeight, CharHeight) * _getFloatOrDef(_scale, 1) };
+			
+			virtual uint64_t _getLayoutSequence() override {
+				const auto baseSeq = UIComponentContainer::_getLayoutSequence();
+				return ( _measureSequence < baseSeq ) ? baseSeq : _measureSequence;
+			}
+
+			virtual uint64_t _getDrawSequence() override {
+				const auto baseSeq = UIComponentContainer::_getDrawSequence();
+				const auto varSeq  = _getMaxSequence( _text, _scale );
+				return ( varSeq < baseSeq ) ? baseSeq : varSeq;
 			}
 
-			virtual bool draw(SP_UIRenderDriverApi& spApi, const UIRenderContext& rCtx) override {
-				const auto bbox = getInnerBBox();
+			virtual UIPosValVariant     getStyleWidth () override { return UIPosValVariant{ UIPosValVariant::Pixel, _measureSize.x }; }
+			virtual UIPosValVariant     getStyleHeight() override { return UIPosValVariant{ UIPosValVariant::Pixel, _measureSize.y }; }
+
+			virtual bool draw(UIRenderCommandBuffer& cmdBuffer, const UIRenderContext& rCtx) override {
+				const auto& bbox = getInnerBBoxRef();
+				
+				if ( _text.readInvalidate() )
+					_cacheText = _text.getUIString();
 				
-				spApi->drawText( _text.getString(), bbox.min, _getFloatOrDef(_scale, 1), rCtx.color );
+				cmdBuffer.addText( _cacheText, bbox, _getFloatOrDef(_scale, 1), rCtx.color );
 				return true;
 			}
 	};
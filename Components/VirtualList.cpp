@@ -0,0 +1,178 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	class UIComponent_VirtualListItem : public UIComponentContainer {
+		public:
+			/// extent of the laid out children along the list axis
+			float measure(const bool column) {
+				const auto& innerBBox = getInnerBBoxRef();
+
+				float size = 0;
+				for(auto& childNode : getChildRenderNodeListRef()) {
+					const auto outerBBox = childNode->getOuterBBox();
+					size = max(size, column ? outerBBox.max.y - innerBBox.min.y : outerBBox.max.x - innerBBox.min.x);
+				}
+				return size;
+			}
+	};
+
+	/// Instantiates only the elements of list that intersect its inner box.
+	///
+	///		VirtualList list=$rows itemsize=24px scroll=$scrollY column
+	///			TextLine text=$item.name
+	///
+	/// Every visible element gets an absolute VirtualListItem with $item and $index bound. Items are kept
+	/// per list element, rows that scroll out go to a free list and are rebound to the elements that come
+	/// into view, so a subtree is only built when the free list is empty.
+	/// Without itemsize the extent is measured from the first visible item, one frame late.
+	class UIComponent_VirtualList : public UIComponentContainer {
+		private:
+			struct TSlot {
+				SP_UIComponent spNode = nullptr;
+				UIVar          index;
+				UIVar          pos;
+				UIVar          size;
+			};
+			using TSlotMap = std::unordered_multimap< const void*, TSlot >;
+
+			UIVar _list;
+			UIVar _itemSize;
+			UIVar _scroll;
+			UIVar _clipStyle;
+
+			SP_UINodeDesc         _spItemNodeDesc = nullptr;
+			TSlotMap              _slotMap;
+			std::vector< TSlot >  _freeSlotList;
+			std::vector< size_t > _pendingIndexList;
+
+			bool   _column       = false;
+			size_t _first        = 0;
+			size_t _last         = 0;
+			float  _offset       = 0;
+			float  _extent       = 0;
+			float  _measuredSize = 0;
+
+			TSlot _createSlot(UIVar item, const bool column) {
+				auto varEnv = createChildVarEnv();
+				varEnv->setVar("item", item);
+				varEnv->getVar("abs").setBool(true);
+				varEnv->getVar( column ? "w" : "h" ).setPercent(1);
+
+				TSlot slot;
+				slot.index  = varEnv->getVar("index");
+				slot.pos    = varEnv->getVar( column ? "top" : "left" );
+				slot.size   = varEnv->getVar( column ? "h"   : "w"    );
+				/// an internal row wrapper, built here rather than through the component names of createUINode
+				slot.spNode = arenaMakeShared< UIComponent_VirtualListItem >( varEnv->getArena() );
+				slot.spNode->create( _spItemNodeDesc, varEnv, shared_from_this() );
+				return slot;
+			}
+			TSlot _reuseSlot(UIVar item) {
+				auto slot = _freeSlotList.back();
+				_freeSlotList.pop_back();
+
+				slot.spNode->setVar("item", item);
+				slot.spNode->rebindWalk();
+				return slot;
+			}
+			void _placeSlot(TSlot& slot, const size_t index, const float extent, const float offset) {
+				/// plain floats are used as exact pixels, style pixels are read through getFraction() and clamp at 1
+				slot.index.setI32( (int32_t)index );
+				slot.pos  .setFloat( (float)index * extent - offset );
+				if ( !_itemSize.isNull() )
+					slot.size.setFloat(extent);
+			}
+
+		protected:
+			virtual void _init_VarLink() override {
+				UIComponentContainer::_init_VarLink();
+
+				_list      = getVar("list");
+				_itemSize  = getVar("itemsize");
+				_scroll    = getVar("scroll");
+				_clipStyle = getVar("clip");
+			}
+
+			virtual void _update_ChildNodeList(UIComponentList& outList, SP_UINodeDesc& spNodeDesc) override {
+				const bool  column    = getStyleDirection() == UIEnumDirection::Column;
+				const auto& innerBBox = getInnerBBoxRef();
+				const float viewport  = column ? innerBBox.getHeight() : innerBBox.getWidth();
+				const float offset    = _scroll.getFloat();
+
+				if ( _itemSize.isNull() && outList.size() && column == _column )
+					_measuredSize = static_cast< UIComponent_VirtualListItem* >( outList.front().get() )->measure(column);
+
+				const float  extent = _itemSize.isNull() ? _measuredSize : _getPosVariant(_itemSize).calc(viewport);
+				const size_t count  = _list.list_GetSize();
+
+				/// until the extent is known only the first element is created, so it can be measured
+				size_t first = 0;
+				size_t last  = count ? 1 : 0;
+				if ( extent > 0 ) {
+					first = (size_t)clamp( 0, std::floor(   offset               / extent ), (float)count );
+					last  = (size_t)clamp( 0, std::ceil ( ( offset + viewport ) / extent ), (float)count );
+				}
+
+				const bool listChanged = _list.readInvalidate();
+				if ( !listChanged && column == _column && first == _first && last == _last && offset == _offset && extent == _extent )
+					return;
+
+				if ( column != _column ) {
+					_slotMap.clear();
+					_freeSlotList.clear();
+				}
+
+				_column = column;
+				_first  = first;
+				_last   = last;
+				_offset = offset;
+				_extent = extent;
+
+				if ( !_spItemNodeDesc )
+					_spItemNodeDesc = UINodeDesc::create("VirtualListItem", {}, { spNodeDesc->getChildNodes() });
+
+				TSlotMap slotMap;
+				outList.clear();
+				_pendingIndexList.clear();
+				for(size_t i = first; i < last; i++) {
+					auto item = _list.list_Get(i);
+
+					auto it = _slotMap.find( item.getId() );
+					if ( it == _slotMap.end() ) {
+						_pendingIndexList.push_back(i);
+						outList.push_back(nullptr);
+						continue;
+					}
+
+					_placeSlot(it->second, i, extent, offset);
+					outList.push_back( it->second.spNode );
+					slotMap.emplace( item.getId(), it->second );
+					_slotMap.erase(it);
+				}
+
+				/// whatever is left scrolled out or was removed from the list
+				for(auto& rec : _slotMap)
+					_freeSlotList.push_back( rec.second );
+				_slotMap.swap(slotMap);
+
+				for(const auto i : _pendingIndexList) {
+					auto item = _list.list_Get(i);
+					auto slot = _freeSlotList.empty() ? _createSlot(item, column) : _reuseSlot(item);
+
+					_placeSlot(slot, i, extent, offset);
+					outList[ i - first ] = slot.spNode;
+					_slotMap.emplace( item.getId(), slot );
+				}
+			}
+
+		public:
+			virtual bool getStyleRelative() override { return true; }
+			/// rows straddling the edges are cut unless clip is set
+			virtual bool getStyleClip    () override { return _clipStyle.isNull() || _clipStyle.getBool(); }
+
+			size_t getInstanceCount () const { return _slotMap.size(); }
+			size_t getFreeSlotCount () const { return _freeSlotList.size(); }
+	};
+
+}
@@ -448,7 +448,8 @@ namespace UIMiniEmbed::Parser {
 	};
 	
 	
-	ParserResult parse(const std::string& text) {
+	/// with pArena the resulting tree is allocated from it, see UIArena
+	ParserResult parse(const std::string& text, UIArena* pArena = nullptr) {
 
 		const char CSpace = '\x20';
 		const char CTab   = '\x09';
@@ -772,7 +773,7 @@ namespace UIMiniEmbed::Parser {
 
 		auto nodeRoot = UINodeDesc::create("Root", {}, nodeGroup);
 		UINodeDesc::TBuildAliasError buildAliasError;
-		nodeRoot = nodeRoot->buildAliasSelf(buildAliasError, nodeGroup.nodeAliasMap);
+		nodeRoot = nodeRoot->buildAliasSelf(buildAliasError, nodeGroup.nodeAliasMap, {}, pArena);
 		if ( !nodeRoot || buildAliasError.isError() )
 			return { buildAliasError.errorText };
 
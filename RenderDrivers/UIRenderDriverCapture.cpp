@@ -0,0 +1,507 @@
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+
+namespace UIMiniEmbed {
+
+	/// Binary draw call trace written by UIRenderDriverCapture and played back by UIRenderTracePlayer.
+	/// A header, then ops of one type byte and a fixed payload, little endian. Strings go into the trace
+	/// once and are referenced by index after that. Handles are the captured driver's, Resolve and
+	/// CreateLayer ops tie them to paths and layers so a player can map them onto another driver.
+	namespace UIRenderTrace {
+		static constexpr uint8_t  Magic[4] = { 'U', 'I', 'T', 'R' };
+		/// 2 added TextBlock, version 1 traces still play
+		static constexpr uint32_t Version  = 2;
+
+		enum EnumOp : uint8_t {
+			FrameEnd,      /// one submit(), or the direct calls made since the last one
+			String,        /// u32 length, bytes.  Next string index
+			Resolve,       /// u32 string, u32 handle
+			CreateLayer,   /// u32 handle
+			ReleaseLayer,  /// u32 handle
+			Sprite,        /// u32 string, srcBBox, dstBBox, color
+			SpriteHandle,  /// u32 handle, srcBBox, dstBBox, color
+			Text,          /// u32 string, f32 x, f32 y, f32 scale, color
+			Clip,          /// bbox
+			ClipReset,
+			LayerBegin,    /// u32 handle, bbox
+			LayerEnd,
+			TextBlock,     /// u32 string, f32 x, f32 y, f32 lineHeight, f32 scale, color
+		};
+
+		inline bool saveFile(const std::string& path, const std::vector< uint8_t >& data) {
+			auto* pFile = std::fopen( path.c_str(), "wb" );
+			if ( !pFile )
+				return false;
+
+			const bool ok = std::fwrite( data.data(), 1, data.size(), pFile ) == data.size();
+			return ( std::fclose(pFile) == 0 ) && ok;
+		}
+		inline bool loadFile(const std::string& path, std::vector< uint8_t >& outData) {
+			auto* pFile = std::fopen( path.c_str(), "rb" );
+			if ( !pFile )
+				return false;
+
+			outData.clear();
+			uint8_t buffer[ 64 * 1024 ];
+			size_t  size;
+			while( ( size = std::fread( buffer, 1, sizeof(buffer), pFile ) ) > 0 )
+				outData.insert( outData.end(), buffer, buffer + size );
+
+			const bool ok = !std::ferror(pFile);
+			std::fclose(pFile);
+			return ok;
+		}
+	}
+
+	/// Driver wrapper that writes every draw call into a trace and passes it on to the wrapped driver,
+	/// which may be nullptr to only capture. submit() and submitBatched() reach the wrapped driver as
+	/// one call, so its own batching still runs. Two captures of the same frames give the same bytes.
+	///
+	///		auto spCapture = UIRenderDriverCapture::create(spDriver);
+	///		root->drawAll(spCapture);
+	///		UIRenderTrace::saveFile( "frame.uitrace", spCapture->getTraceRef() );
+	class UIRenderDriverCapture : public UIRenderDriverApi {
+		private:
+			SP_UIRenderDriverApi _spDriver;
+
+			std::vector< uint8_t >                      _trace;
+			std::vector< UIString >                     _stringList;
+			std::unordered_map< const void*, uint32_t > _stringIndexMap;
+			size_t                                      _frameCount = 0;
+
+			void _putU8 (const uint8_t  value) { _trace.push_back(value); }
+			void _putU32(const uint32_t value) {
+				for(uint32_t shift = 0; shift < 32; shift += 8)
+					_trace.push_back( value >> shift );
+			}
+			void _putF32(const float value) {
+				uint32_t bits;
+				std::memcpy( &bits, &value, sizeof(bits) );
+				_putU32(bits);
+			}
+			void _putBBox (const BBox& bbox)         { _putF32(bbox.min.x); _putF32(bbox.min.y); _putF32(bbox.max.x); _putF32(bbox.max.y); }
+			void _putColor(const Utils::Color color) { _putU8(color.r); _putU8(color.g); _putU8(color.b); _putU8(color.a); }
+
+			uint32_t _putString(const UIString& str) {
+				const auto it = _stringIndexMap.find( str.getId() );
+				if ( it != _stringIndexMap.end() )
+					return it->second;
+
+				const auto& ref = str.getRef();
+				_putU8( UIRenderTrace::String );
+				_putU32( (uint32_t)ref.size() );
+				_trace.insert( _trace.end(), ref.begin(), ref.end() );
+
+				const auto index = (uint32_t)_stringList.size();
+				_stringList.push_back(str);
+				_stringIndexMap.emplace( str.getId(), index );
+				return index;
+			}
+
+			void _writeSprite(const UIString& file, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) {
+				const auto index = _putString(file);
+				_putU8( UIRenderTrace::Sprite );
+				_putU32(index);
+				_putBBox(srcBBox);
+				_putBBox(dstBBox);
+				_putColor(color);
+			}
+			void _writeSprite(const UIResourceHandle handle, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) {
+				_putU8( UIRenderTrace::SpriteHandle );
+				_putU32(handle);
+				_putBBox(srcBBox);
+				_putBBox(dstBBox);
+				_putColor(color);
+			}
+			void _writeText(const UIString& text, const Vec2& pos, const float scale, const Utils::Color color) {
+				const auto index = _putString(text);
+				_putU8( UIRenderTrace::Text );
+				_putU32(index);
+				_putF32(pos.x);
+				_putF32(pos.y);
+				_putF32(scale);
+				_putColor(color);
+			}
+			void _writeTextBlock(const UIString& text, const Vec2& pos, const float lineHeight, const float scale, const Utils::Color color) {
+				const auto index = _putString(text);
+				_putU8( UIRenderTrace::TextBlock );
+				_putU32(index);
+				_putF32(pos.x);
+				_putF32(pos.y);
+				_putF32(lineHeight);
+				_putF32(scale);
+				_putColor(color);
+			}
+			void _writeCommand(const UIRenderCommandBuffer& cmdBuffer, const UIRenderCommand& cmd) {
+				switch( cmd.type ) {
+					case UIRenderCommand::Sprite    :
+						if ( cmd.handle )
+							_writeSprite( cmd.handle, cmd.srcBBox, cmd.dstBBox, cmd.color );
+						else
+							_writeSprite( cmdBuffer.getString(cmd.resource), cmd.srcBBox, cmd.dstBBox, cmd.color );
+						break;
+					case UIRenderCommand::Text      : _writeText( cmdBuffer.getString(cmd.resource), cmd.dstBBox.min, cmd.scale, cmd.color ); break;
+					case UIRenderCommand::TextBlock : _writeTextBlock( cmdBuffer.getString(cmd.resource), cmd.dstBBox.min, cmd.srcBBox.max.y, cmd.scale, cmd.color ); break;
+					case UIRenderCommand::Clip      : _putU8( UIRenderTrace::Clip ); _putBBox(cmd.dstBBox); break;
+					case UIRenderCommand::ClipReset : _putU8( UIRenderTrace::ClipReset ); break;
+					case UIRenderCommand::LayerBegin: _putU8( UIRenderTrace::LayerBegin ); _putU32(cmd.handle); _putBBox(cmd.dstBBox); break;
+					case UIRenderCommand::LayerEnd  : _putU8( UIRenderTrace::LayerEnd ); break;
+				}
+			}
+			void _writeFrameEnd() {
+				_putU8( UIRenderTrace::FrameEnd );
+				_frameCount++;
+			}
+
+		public:
+			UIRenderDriverCapture(const SP_UIRenderDriverApi& spDriver) : _spDriver(spDriver) {
+				clear();
+			}
+
+			/// drops the trace and its string table, handles resolved before stay known only to the driver
+			void clear() {
+				_trace.assign( UIRenderTrace::Magic, UIRenderTrace::Magic + 4 );
+				_putU32( UIRenderTrace::Version );
+				_stringList.clear();
+				_stringIndexMap.clear();
+				_frameCount = 0;
+			}
+
+			const std::vector< uint8_t >& getTraceRef  () const { return _trace;      }
+			size_t                        getFrameCount() const { return _frameCount; }
+			const SP_UIRenderDriverApi&   getDriverRef () const { return _spDriver;   }
+
+			virtual void drawSprite(const std::string& file, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) override {
+				drawSprite( UIString(file), srcBBox, dstBBox, color );
+			}
+			virtual void drawText(const std::string& text, const Vec2& pos, const float scale, const Utils::Color color) override {
+				drawText( UIString(text), pos, scale, color );
+			}
+			virtual void drawSprite(const UIString& file, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) override {
+				_writeSprite(file, srcBBox, dstBBox, color);
+				if ( _spDriver )
+					_spDriver->drawSprite(file, srcBBox, dstBBox, color);
+			}
+			virtual void drawText(const UIString& text, const Vec2& pos, const float scale, const Utils::Color color) override {
+				_writeText(text, pos, scale, color);
+				if ( _spDriver )
+					_spDriver->drawText(text, pos, scale, color);
+			}
+			virtual void drawTextBlock(const UIString& text, const Vec2& pos, const float lineHeight, const float scale, const Utils::Color color) override {
+				_writeTextBlock(text, pos, lineHeight, scale, color);
+				if ( _spDriver )
+					_spDriver->drawTextBlock(text, pos, lineHeight, scale, color);
+			}
+			virtual void drawSprite(const UIResourceHandle handle, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) override {
+				_writeSprite(handle, srcBBox, dstBBox, color);
+				if ( _spDriver )
+					_spDriver->drawSprite(handle, srcBBox, dstBBox, color);
+			}
+			virtual void drawSpriteBatch(const UIResourceHandle handle, const UIRenderCommand* pCommandList, const size_t count) override {
+				for(size_t i = 0; i < count; i++)
+					_writeSprite( handle, pCommandList[i].srcBBox, pCommandList[i].dstBBox, pCommandList[i].color );
+				if ( _spDriver )
+					_spDriver->drawSpriteBatch(handle, pCommandList, count);
+			}
+
+			virtual UIResourceHandle resolveResource(const UIString& path) override {
+				const auto handle = _spDriver ? _spDriver->resolveResource(path) : 0;
+				if ( handle ) {
+					const auto index = _putString(path);
+					_putU8( UIRenderTrace::Resolve );
+					_putU32(index);
+					_putU32(handle);
+				}
+				return handle;
+			}
+			virtual void preloadResource(const UIString& path) override {
+				if ( _spDriver )
+					_spDriver->preloadResource(path);
+			}
+			virtual bool isResourceReady(const UIString& path) override {
+				return _spDriver ? _spDriver->isResourceReady(path) : true;
+			}
+			virtual bool measureText(const std::string& text, const float scale, Vec2& outSize) override {
+				return _spDriver ? _spDriver->measureText(text, scale, outSize) : false;
+			}
+			virtual bool measureText(const UIString& text, const float scale, Vec2& outSize) override {
+				return _spDriver ? _spDriver->measureText(text, scale, outSize) : false;
+			}
+
+			virtual void setClipRect(const BBox& clipBBox) override {
+				_putU8( UIRenderTrace::Clip );
+				_putBBox(clipBBox);
+				if ( _spDriver )
+					_spDriver->setClipRect(clipBBox);
+			}
+			virtual void clearClipRect() override {
+				_putU8( UIRenderTrace::ClipReset );
+				if ( _spDriver )
+					_spDriver->clearClipRect();
+			}
+
+			virtual UIResourceHandle createLayer() override {
+				const auto handle = _spDriver ? _spDriver->createLayer() : 0;
+				if ( handle ) {
+					_putU8( UIRenderTrace::CreateLayer );
+					_putU32(handle);
+				}
+				return handle;
+			}
+			virtual void releaseLayer(const UIResourceHandle handle) override {
+				_putU8( UIRenderTrace::ReleaseLayer );
+				_putU32(handle);
+				if ( _spDriver )
+					_spDriver->releaseLayer(handle);
+			}
+			virtual void beginLayer(const UIResourceHandle handle, const BBox& bbox) override {
+				_putU8( UIRenderTrace::LayerBegin );
+				_putU32(handle);
+				_putBBox(bbox);
+				if ( _spDriver )
+					_spDriver->beginLayer(handle, bbox);
+			}
+			virtual void endLayer() override {
+				_putU8( UIRenderTrace::LayerEnd );
+				if ( _spDriver )
+					_spDriver->endLayer();
+			}
+
+			virtual void submit(const UIRenderCommandBuffer& cmdBuffer) override {
+				for(const auto& cmd : cmdBuffer.getCommandListRef())
+					_writeCommand(cmdBuffer, cmd);
+				_writeFrameEnd();
+				if ( _spDriver )
+					_spDriver->submit(cmdBuffer);
+			}
+			virtual void submitFrame(const SP_UIRenderCommandBuffer& spCmdBuffer) override {
+				for(const auto& cmd : spCmdBuffer->getCommandListRef())
+					_writeCommand(*spCmdBuffer, cmd);
+				_writeFrameEnd();
+				if ( _spDriver )
+					_spDriver->submitFrame(spCmdBuffer);
+			}
+			/// recorded in the batched order, the order the driver draws in
+			virtual void submitBatched(const UIRenderCommandBuffer& cmdBuffer, const UIRenderBatcher& batcher) override {
+				for(const auto& cmd : batcher.getCommandListRef())
+					_writeCommand(cmdBuffer, cmd);
+				_writeFrameEnd();
+				if ( _spDriver )
+					_spDriver->submitBatched(cmdBuffer, batcher);
+			}
+
+			static std::shared_ptr< UIRenderDriverCapture > create(const SP_UIRenderDriverApi& spDriver = nullptr) {
+				return std::make_shared< UIRenderDriverCapture >(spDriver);
+			}
+	};
+	using SP_UIRenderDriverCapture = std::shared_ptr< UIRenderDriverCapture >;
+
+	/// Feeds a trace to a driver one frame per nextFrame(), each as a single submit().
+	/// Paths are resolved and layers created on that driver as the trace reaches them, captured handles
+	/// it does not know fall back to the path. Decoding reuses one command buffer, so a loop over the
+	/// frames measures little more than the driver.
+	///
+	///		UIRenderTracePlayer player;
+	///		if ( player.open(trace) )
+	///			while( player.nextFrame(*spDriver) ) {}
+	class UIRenderTracePlayer {
+		private:
+			struct THandle {
+				UIResourceHandle handle = 0;
+				/// path of a resolved handle, -1 for layers
+				int32_t          string = -1;
+			};
+
+			const std::vector< uint8_t >* _pTrace     = nullptr;
+			size_t                        _pos        = 0;
+			size_t                        _frameIndex = 0;
+			bool                          _error      = false;
+
+			std::vector< UIString >                         _stringList;
+			std::unordered_map< UIResourceHandle, THandle > _handleMap;
+			UIRenderCommandBuffer                           _cmdBuffer;
+
+			bool _has(const size_t size) {
+				if ( _pos + size > _pTrace->size() )
+					_error = true;
+				return !_error;
+			}
+			uint8_t _getU8() {
+				return _has(1) ? (*_pTrace)[ _pos++ ] : 0;
+			}
+			uint32_t _getU32() {
+				if ( !_has(4) )
+					return 0;
+
+				const uint8_t* p = &(*_pTrace)[_pos];
+				_pos += 4;
+				return (uint32_t)p[0] | ( (uint32_t)p[1] << 8 ) | ( (uint32_t)p[2] << 16 ) | ( (uint32_t)p[3] << 24 );
+			}
+			float _getF32() {
+				const uint32_t bits = _getU32();
+				float value;
+				std::memcpy( &value, &bits, sizeof(value) );
+				return value;
+			}
+			BBox _getBBox() {
+				BBox bbox;
+				bbox.min.x = _getF32();
+				bbox.min.y = _getF32();
+				bbox.max.x = _getF32();
+				bbox.max.y = _getF32();
+				return bbox;
+			}
+			Utils::Color _getColor() {
+				Utils::Color color;
+				color.r = _getU8();
+				color.g = _getU8();
+				color.b = _getU8();
+				color.a = _getU8();
+				return color;
+			}
+			const UIString& _getString() {
+				static const UIString sEmpty;
+				const uint32_t index = _getU32();
+				if ( index >= _stringList.size() ) {
+					_error = true;
+					return sEmpty;
+				}
+				return _stringList[index];
+			}
+
+		public:
+			/// the trace is read in place and has to outlive the playback
+			bool open(const std::vector< uint8_t >& trace) {
+				_pTrace     = &trace;
+				_pos        = 0;
+				_frameIndex = 0;
+				_error      = false;
+				_stringList.clear();
+				_handleMap .clear();
+
+				if ( trace.size() < 8 || std::memcmp( trace.data(), UIRenderTrace::Magic, 4 ) ) {
+					_error = true;
+					return false;
+				}
+				_pos = 4;
+				const uint32_t version = _getU32();
+				if ( version < 1 || version > UIRenderTrace::Version )
+					_error = true;
+				return !_error;
+			}
+
+			/// false at the end of the trace or on a malformed one, a trailing frame without FrameEnd is still played
+			bool nextFrame(UIRenderDriverApi& api) {
+				if ( !_pTrace || _error || _pos >= _pTrace->size() )
+					return false;
+
+				_cmdBuffer.clear();
+				while( !_error && _pos < _pTrace->size() ) {
+					const auto op = (UIRenderTrace::EnumOp)_getU8();
+					if ( op == UIRenderTrace::FrameEnd )
+						break;
+
+					switch( op ) {
+						case UIRenderTrace::String: {
+							const uint32_t size = _getU32();
+							if ( !_has(size) )
+								break;
+							_stringList.push_back( UIString( std::string( (const char*)&(*_pTrace)[_pos], size ) ) );
+							_pos += size;
+							break;
+						}
+						case UIRenderTrace::Resolve: {
+							const uint32_t index  = _getU32();
+							const uint32_t handle = _getU32();
+							if ( index >= _stringList.size() ) {
+								_error = true;
+								break;
+							}
+							_handleMap[handle] = THandle{ api.resolveResource( _stringList[index] ), (int32_t)index };
+							break;
+						}
+						case UIRenderTrace::CreateLayer: {
+							const uint32_t handle = _getU32();
+							_handleMap[handle] = THandle{ api.createLayer() };
+							break;
+						}
+						case UIRenderTrace::ReleaseLayer: {
+							const auto it = _handleMap.find( _getU32() );
+							if ( it != _handleMap.end() ) {
+								if ( it->second.handle )
+									api.releaseLayer(it->second.handle);
+								_handleMap.erase(it);
+							}
+							break;
+						}
+						case UIRenderTrace::Sprite: {
+							const auto& file    = _getString();
+							const auto  srcBBox = _getBBox();
+							const auto  dstBBox = _getBBox();
+							const auto  color   = _getColor();
+							_cmdBuffer.addSprite(file, 0, srcBBox, dstBBox, color);
+							break;
+						}
+						case UIRenderTrace::SpriteHandle: {
+							const auto it      = _handleMap.find( _getU32() );
+							const auto srcBBox = _getBBox();
+							const auto dstBBox = _getBBox();
+							const auto color   = _getColor();
+							if ( it == _handleMap.end() )
+								break;
+							if ( it->second.handle )
+								_cmdBuffer.addSprite(UIString(), it->second.handle, srcBBox, dstBBox, color);
+							else if ( it->second.string >= 0 )
+								_cmdBuffer.addSprite(_stringList[ it->second.string ], 0, srcBBox, dstBBox, color);
+							break;
+						}
+						case UIRenderTrace::Text: {
+							const auto& text  = _getString();
+							Vec2 pos;
+							pos.x = _getF32();
+							pos.y = _getF32();
+							const float scale = _getF32();
+							const auto  color = _getColor();
+							_cmdBuffer.addText(text, BBox{ pos, pos }, scale, color);
+							break;
+						}
+						case UIRenderTrace::TextBlock: {
+							const auto& text  = _getString();
+							Vec2 pos;
+							pos.x = _getF32();
+							pos.y = _getF32();
+							const float lineHeight = _getF32();
+							const float scale      = _getF32();
+							const auto  color      = _getColor();
+							_cmdBuffer.addTextBlock(text, BBox{ pos, pos }, lineHeight, scale, color);
+							break;
+						}
+						case UIRenderTrace::Clip      : _cmdBuffer.addClip( _getBBox() ); break;
+						case UIRenderTrace::ClipReset : _cmdBuffer.addClipReset(); break;
+						case UIRenderTrace::LayerBegin: {
+							const auto it   = _handleMap.find( _getU32() );
+							const auto bbox = _getBBox();
+							_cmdBuffer.addLayerBegin( it != _handleMap.end() ? it->second.handle : 0, bbox );
+							break;
+						}
+						case UIRenderTrace::LayerEnd  : _cmdBuffer.addLayerEnd(); break;
+						default:
+							_error = true;
+							break;
+					}
+				}
+				if ( _error )
+					return false;
+
+				api.submit(_cmdBuffer);
+				_frameIndex++;
+				return true;
+			}
+
+			size_t getFrameIndex() const { return _frameIndex; }
+			bool   isError      () const { return _error;      }
+	};
+
+}
@@ -0,0 +1,553 @@
+#pragma once
+
+#include <cstdio>
+
+namespace UIMiniEmbed {
+
+	/// Reference CPU driver, rasterizes into an RGBA8 framebuffer held in memory.
+	/// Images are added by the host already decoded. Text uses a built-in 5x7 font in a 7x11 cell,
+	/// the same metrics TextLine falls back to, laid out once per text and scale in a UIGlyphRunCache.
+	/// Blending is premultiplied source over, SSE2 when available, and the scalar path gives identical pixels.
+	/// Layers are images drawn into between beginLayer and endLayer, shown like any other handle.
+	///
+	///		auto spDriver = UIRenderDriverSoftware::create(320, 240);
+	///		spDriver->addImage("icons.png", w, h, pRGBA);
+	///		spDriver->clear(0xFF000000);
+	///		root->drawAll(spApi);
+	///		spDriver->savePNG("frame.png");
+	class UIRenderDriverSoftware : public UIRenderDriverApi {
+		public:
+			enum class EnumSampling : uint8_t {
+				Nearest,
+				Bilinear,
+			};
+
+			static constexpr int32_t CellWidth  = 7;
+			static constexpr int32_t CellHeight = 11;
+
+		private:
+			/// premultiplied RGBA8, r in the low byte
+			struct TImage {
+				int32_t                 width  = 0;
+				int32_t                 height = 0;
+				std::vector< uint32_t > pixelList;
+			};
+
+			int32_t                 _width  = 0;
+			int32_t                 _height = 0;
+			std::vector< uint32_t > _pixelList;
+			std::vector< uint32_t > _spanList;
+
+			std::vector< TImage >                               _imageList;
+			std::unordered_map< std::string, UIResourceHandle > _handleMap;
+
+			/// where draws land, the framebuffer or a layer, origin is the screen position of its first pixel
+			struct TTarget {
+				uint32_t* pPixel  = nullptr;
+				int32_t   width   = 0;
+				int32_t   height  = 0;
+				Vec2      origin;
+				BBox      clip;
+				bool      hasClip = false;
+			};
+
+			EnumSampling _sampling = EnumSampling::Nearest;
+			TTarget      _target;
+
+			std::vector< TTarget >          _layerStack;
+			std::vector< UIResourceHandle > _freeLayerList;
+
+			UIGlyphRunCache _glyphRunCache;
+
+			/// columns of ' ' to '~', bit 0 is the top row
+			static const uint8_t* _getGlyph(const char c) {
+				static const uint8_t sFont[95][5] = {
+					{0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+					{0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x55,0x22,0x50}, {0x00,0x05,0x03,0x00,0x00},
+					{0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x08,0x2A,0x1C,0x2A,0x08}, {0x08,0x08,0x3E,0x08,0x08},
+					{0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x60,0x60,0x00,0x00}, {0x20,0x10,0x08,0x04,0x02},
+					{0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4B,0x31},
+					{0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03},
+					{0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1E}, {0x00,0x36,0x36,0x00,0x00}, {0x00,0x56,0x36,0x00,0x00},
+					{0x08,0x14,0x22,0x41,0x00}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x51,0x09,0x06},
+					{0x32,0x49,0x79,0x41,0x3E}, {0x7E,0x11,0x11,0x11,0x7E}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+					{0x7F,0x41,0x41,0x22,0x1C}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x49,0x49,0x7A},
+					{0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+					{0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x0C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+					{0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x46,0x49,0x49,0x49,0x31},
+					{0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},
+					{0x63,0x14,0x08,0x14,0x63}, {0x07,0x08,0x70,0x08,0x07}, {0x61,0x51,0x49,0x45,0x43}, {0x00,0x7F,0x41,0x41,0x00},
+					{0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x7F,0x00}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+					{0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78}, {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20},
+					{0x38,0x44,0x44,0x48,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x08,0x7E,0x09,0x01,0x02}, {0x0C,0x52,0x52,0x52,0x3E},
+					{0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x44,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},
+					{0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x18,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+					{0x7C,0x14,0x14,0x14,0x08}, {0x08,0x14,0x14,0x18,0x7C}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20},
+					{0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+					{0x44,0x28,0x10,0x28,0x44}, {0x0C,0x50,0x50,0x50,0x3C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+					{0x00,0x00,0x7F,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x08,0x04,0x08,0x10,0x08},
+				};
+				if ( c < ' ' || c > '~' )
+					return sFont['?' - ' '];
+				return sFont[c - ' '];
+			}
+
+			/// one quad per vertical stroke of a glyph column, srcBBox in font pixels with glyphs side by side.
+			/// With a lineHeight '\n' starts a new line that much lower, without it the string is one line.
+			SP_UIGlyphRun _getGlyphRun(const UIString& text, const float scale, const float lineHeight = 0) {
+				return _glyphRunCache.get( text, scale, lineHeight, 0, [&](UIGlyphRun& run) {
+					const auto& str = text.getRef();
+
+					/// glyphs sit one column and two rows into their cell
+					size_t column    = 0;
+					size_t maxColumn = 0;
+					float  lineY     = 0;
+					for(size_t c = 0; c < str.size(); c++) {
+						if ( lineHeight > 0 && str[c] == '\n' ) {
+							column  = 0;
+							lineY  += lineHeight;
+							continue;
+						}
+
+						const size_t i = column++;
+						maxColumn = maxColumn > column ? maxColumn : column;
+
+						const auto* pGlyph = _getGlyph( str[c] );
+						const float glyphX = (float)( pGlyph - _getGlyph(' ') );
+						for(int32_t col = 0; col < 5; col++) {
+							int32_t row = 0;
+							while( row < 7 ) {
+								if ( !( pGlyph[col] & ( 1 << row ) ) ) {
+									row++;
+									continue;
+								}
+
+								const int32_t rowBegin = row;
+								while( row < 7 && ( pGlyph[col] & ( 1 << row ) ) )
+									row++;
+
+								UIGlyphQuad quad;
+								quad.srcBBox = BBox{ Vec2{ glyphX + col, (float)rowBegin }, Vec2{ glyphX + col + 1, (float)row } };
+								quad.dstBBox = BBox{
+									Vec2{ (float)( i * CellWidth + 1 + col ) * scale, lineY + (float)( 2 + rowBegin ) * scale },
+									Vec2{ (float)( i * CellWidth + 2 + col ) * scale, lineY + (float)( 2 + row      ) * scale },
+								};
+								run.quadList.push_back(quad);
+							}
+						}
+					}
+					run.size = Vec2{ (float)( CellWidth * maxColumn ) * scale, lineY + (float)CellHeight * scale };
+				} );
+			}
+
+			static int32_t _clampIndex(const int32_t v, const int32_t size) {
+				return v < 0 ? 0 : ( v >= size ? size - 1 : v );
+			}
+			static uint32_t _mulDiv255(const uint32_t a, const uint32_t b) {
+				const uint32_t t = a * b + 128;
+				return ( t + ( t >> 8 ) ) >> 8;
+			}
+			static uint32_t _pack(const uint32_t r, const uint32_t g, const uint32_t b, const uint32_t a) {
+				return r | ( g << 8 ) | ( b << 16 ) | ( a << 24 );
+			}
+			/// texel * color, both premultiplied result
+			static uint32_t _tint(const uint32_t texel, const Utils::Color color) {
+				const uint32_t a = _mulDiv255( texel >> 24, color.a );
+				return _pack(
+					_mulDiv255( _mulDiv255( texel         & 0xFF, color.r ), color.a ),
+					_mulDiv255( _mulDiv255( ( texel >>  8 ) & 0xFF, color.g ), color.a ),
+					_mulDiv255( _mulDiv255( ( texel >> 16 ) & 0xFF, color.b ), color.a ),
+					a
+				);
+			}
+
+			/// dst = src + dst * ( 255 - src.a ) / 255, src premultiplied
+			static void _blendSpan(uint32_t* pDst, const uint32_t* pSrc, const size_t count) {
+				size_t i = 0;
+#if UIMINIEMBED_SIMD_SSE2
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i c255 = _mm_set1_epi16(255);
+				const __m128i c128 = _mm_set1_epi16(128);
+				for(; i + 2 <= count; i += 2) {
+					const __m128i s = _mm_unpacklo_epi8( _mm_loadl_epi64( (const __m128i*)( pSrc + i ) ), zero );
+					const __m128i d = _mm_unpacklo_epi8( _mm_loadl_epi64( (const __m128i*)( pDst + i ) ), zero );
+
+					__m128i a = _mm_shufflelo_epi16( s, _MM_SHUFFLE(3, 3, 3, 3) );
+					a = _mm_shufflehi_epi16( a, _MM_SHUFFLE(3, 3, 3, 3) );
+
+					__m128i t = _mm_add_epi16( _mm_mullo_epi16( d, _mm_sub_epi16(c255, a) ), c128 );
+					t = _mm_srli_epi16( _mm_add_epi16( t, _mm_srli_epi16(t, 8) ), 8 );
+
+					_mm_storel_epi64( (__m128i*)( pDst + i ), _mm_packus_epi16( _mm_add_epi16(t, s), zero ) );
+				}
+#endif
+				for(; i < count; i++) {
+					const uint32_t s  = pSrc[i];
+					const uint32_t d  = pDst[i];
+					const uint32_t ia = 255 - ( s >> 24 );
+					uint32_t out = 0;
+					for(uint32_t shift = 0; shift < 32; shift += 8) {
+						const uint32_t c = ( ( s >> shift ) & 0xFF ) + _mulDiv255( ( d >> shift ) & 0xFF, ia );
+						out |= ( c > 255 ? 255 : c ) << shift;
+					}
+					pDst[i] = out;
+				}
+			}
+
+			/// pixels whose centers lie in bbox, cut to the clip and the framebuffer, false when empty
+			bool _getPixelRect(const BBox& bbox, int32_t& x0, int32_t& y0, int32_t& x1, int32_t& y1) const {
+				auto rect = _target.hasClip ? bbox.intersect(_target.clip) : bbox;
+				x0 = (int32_t)std::ceil( rect.min.x - _target.origin.x - 0.5f );
+				y0 = (int32_t)std::ceil( rect.min.y - _target.origin.y - 0.5f );
+				x1 = (int32_t)std::ceil( rect.max.x - _target.origin.x - 0.5f );
+				y1 = (int32_t)std::ceil( rect.max.y - _target.origin.y - 0.5f );
+				x0 = x0 < 0 ? 0 : x0;
+				y0 = y0 < 0 ? 0 : y0;
+				x1 = x1 > _target.width  ? _target.width  : x1;
+				y1 = y1 > _target.height ? _target.height : y1;
+				return x0 < x1 && y0 < y1;
+			}
+
+			void _fillRect(const BBox& bbox, const uint32_t premultiplied) {
+				int32_t x0, y0, x1, y1;
+				if ( !_getPixelRect(bbox, x0, y0, x1, y1) )
+					return;
+
+				_spanList.assign( x1 - x0, premultiplied );
+				for(int32_t y = y0; y < y1; y++)
+					_blendSpan( _target.pPixel + y * _target.width + x0, _spanList.data(), _spanList.size() );
+			}
+			void _drawGlyphRun(const UIGlyphRun& run, const Vec2& pos, const Utils::Color color) {
+				const uint32_t a     = color.a;
+				const uint32_t pixel = _pack( _mulDiv255(color.r, a), _mulDiv255(color.g, a), _mulDiv255(color.b, a), a );
+
+				for(const auto& quad : run.quadList)
+					_fillRect( BBox{ pos + quad.dstBBox.min, pos + quad.dstBBox.max }, pixel );
+			}
+
+			uint32_t _sampleNearest(const TImage& image, const float u, const float v) const {
+				const int32_t x = (int32_t)std::floor(u);
+				const int32_t y = (int32_t)std::floor(v);
+				return image.pixelList[ _clampIndex(y, image.height) * image.width + _clampIndex(x, image.width) ];
+			}
+			uint32_t _sampleBilinear(const TImage& image, const float u, const float v) const {
+				const float   fu = u - 0.5f;
+				const float   fv = v - 0.5f;
+				const int32_t x  = (int32_t)std::floor(fu);
+				const int32_t y  = (int32_t)std::floor(fv);
+				const float   wx = fu - (float)x;
+				const float   wy = fv - (float)y;
+
+				const int32_t xa = _clampIndex( x    , image.width  );
+				const int32_t xb = _clampIndex( x + 1, image.width  );
+				const int32_t ya = _clampIndex( y    , image.height );
+				const int32_t yb = _clampIndex( y + 1, image.height );
+
+				const uint32_t t00 = image.pixelList[ ya * image.width + xa ];
+				const uint32_t t10 = image.pixelList[ ya * image.width + xb ];
+				const uint32_t t01 = image.pixelList[ yb * image.width + xa ];
+				const uint32_t t11 = image.pixelList[ yb * image.width + xb ];
+
+				uint32_t out = 0;
+				for(uint32_t shift = 0; shift < 32; shift += 8) {
+					const float top    = (float)( ( t00 >> shift ) & 0xFF ) * ( 1 - wx ) + (float)( ( t10 >> shift ) & 0xFF ) * wx;
+					const float bottom = (float)( ( t01 >> shift ) & 0xFF ) * ( 1 - wx ) + (float)( ( t11 >> shift ) & 0xFF ) * wx;
+					out |= ( (uint32_t)( top * ( 1 - wy ) + bottom * wy + 0.5f ) & 0xFF ) << shift;
+				}
+				return out;
+			}
+
+			void _drawImage(const TImage& image, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) {
+				int32_t x0, y0, x1, y1;
+				if ( !_getPixelRect(dstBBox, x0, y0, x1, y1) || !image.width || !image.height )
+					return;
+
+				/// an empty source box samples the whole image
+				auto src = srcBBox;
+				if ( !( src.getWidth() > 0 && src.getHeight() > 0 ) )
+					src = BBox{ {}, Vec2{ (float)image.width, (float)image.height } };
+
+				const float du = src.getWidth () / dstBBox.getWidth ();
+				const float dv = src.getHeight() / dstBBox.getHeight();
+
+				_spanList.resize( x1 - x0 );
+				for(int32_t y = y0; y < y1; y++) {
+					const float v = src.min.y + ( (float)y + 0.5f + _target.origin.y - dstBBox.min.y ) * dv;
+					for(int32_t x = x0; x < x1; x++) {
+						const float u = src.min.x + ( (float)x + 0.5f + _target.origin.x - dstBBox.min.x ) * du;
+						const uint32_t texel = ( _sampling == EnumSampling::Bilinear ) ? _sampleBilinear(image, u, v) : _sampleNearest(image, u, v);
+						_spanList[ x - x0 ] = _tint(texel, color);
+					}
+					_blendSpan( _target.pPixel + y * _target.width + x0, _spanList.data(), _spanList.size() );
+				}
+			}
+
+			static uint32_t _crc32(const uint8_t* p, const size_t size, uint32_t crc = 0) {
+				static const auto sTable = []() {
+					std::array< uint32_t, 256 > table;
+					for(uint32_t n = 0; n < 256; n++) {
+						uint32_t c = n;
+						for(int k = 0; k < 8; k++)
+							c = ( c & 1 ) ? ( 0xEDB88320u ^ ( c >> 1 ) ) : ( c >> 1 );
+						table[n] = c;
+					}
+					return table;
+				}();
+
+				crc = ~crc;
+				for(size_t i = 0; i < size; i++)
+					crc = sTable[ ( crc ^ p[i] ) & 0xFF ] ^ ( crc >> 8 );
+				return ~crc;
+			}
+
+			static void _putU32BE(std::vector< uint8_t >& out, const uint32_t v) {
+				out.push_back( v >> 24 );
+				out.push_back( v >> 16 );
+				out.push_back( v >>  8 );
+				out.push_back( v       );
+			}
+			static void _putChunk(std::vector< uint8_t >& out, const char* type, const std::vector< uint8_t >& data) {
+				_putU32BE( out, (uint32_t)data.size() );
+				const size_t begin = out.size();
+				out.insert( out.end(), type, type + 4 );
+				out.insert( out.end(), data.begin(), data.end() );
+				_putU32BE( out, _crc32( &out[begin], out.size() - begin ) );
+			}
+
+			static bool _saveFile(const std::string& path, const std::vector< uint8_t >& data) {
+				FILE* pFile = std::fopen( path.c_str(), "wb" );
+				if ( !pFile )
+					return false;
+
+				const bool ok = std::fwrite( data.data(), 1, data.size(), pFile ) == data.size();
+				return ( std::fclose(pFile) == 0 ) && ok;
+			}
+
+		public:
+			using UIRenderDriverApi::drawSprite;
+			using UIRenderDriverApi::drawText;
+			using UIRenderDriverApi::measureText;
+
+			UIRenderDriverSoftware(const int32_t width, const int32_t height) {
+				resize(width, height);
+			}
+
+			void resize(const int32_t width, const int32_t height) {
+				_width  = width  > 0 ? width  : 0;
+				_height = height > 0 ? height : 0;
+				_pixelList.assign( (size_t)_width * _height, 0 );
+				
+				_layerStack.clear();
+				_target = TTarget{ _pixelList.data(), _width, _height };
+			}
+			/// rgba with r in the low byte, not premultiplied
+			void clear(const uint32_t rgba) {
+				const uint32_t a = rgba >> 24;
+				std::fill( _pixelList.begin(), _pixelList.end(),
+					_pack( _mulDiv255( rgba & 0xFF, a ), _mulDiv255( ( rgba >> 8 ) & 0xFF, a ), _mulDiv255( ( rgba >> 16 ) & 0xFF, a ), a ) );
+			}
+			void setSampling(const EnumSampling sampling) { _sampling = sampling; }
+
+			/// pRGBA is width * height pixels, 4 bytes each in r, g, b, a order, not premultiplied.
+			/// Adding a path again replaces its pixels and keeps its handle.
+			UIResourceHandle addImage(const std::string& path, const int32_t width, const int32_t height, const uint8_t* pRGBA) {
+				if ( width <= 0 || height <= 0 || !pRGBA )
+					return 0;
+
+				TImage image;
+				image.width  = width;
+				image.height = height;
+				image.pixelList.resize( (size_t)width * height );
+				for(size_t i = 0; i < image.pixelList.size(); i++) {
+					const uint8_t* p = pRGBA + i * 4;
+					image.pixelList[i] = _pack( _mulDiv255(p[0], p[3]), _mulDiv255(p[1], p[3]), _mulDiv255(p[2], p[3]), p[3] );
+				}
+
+				const auto it = _handleMap.find(path);
+				if ( it != _handleMap.end() ) {
+					_imageList[ it->second - 1 ] = std::move(image);
+					return it->second;
+				}
+
+				_imageList.push_back( std::move(image) );
+				const auto handle = (UIResourceHandle)_imageList.size();
+				_handleMap.emplace( path, handle );
+				return handle;
+			}
+
+			int32_t                        getWidth       () const { return _width;     }
+			int32_t                        getHeight      () const { return _height;    }
+			/// premultiplied RGBA8, r in the low byte, rows top down
+			const std::vector< uint32_t >& getPixelListRef() const { return _pixelList; }
+
+			virtual UIResourceHandle resolveResource(const UIString& path) override {
+				const auto it = _handleMap.find( path.getRef() );
+				return ( it != _handleMap.end() ) ? it->second : 0;
+			}
+			/// images come from the host, a path is ready once addImage() got it
+			virtual bool isResourceReady(const UIString& path) override {
+				return _handleMap.find( path.getRef() ) != _handleMap.end();
+			}
+
+			virtual void drawSprite(const UIResourceHandle handle, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) override {
+				if ( handle && handle <= _imageList.size() )
+					_drawImage( _imageList[ handle - 1 ], srcBBox, dstBBox, color );
+			}
+			virtual void drawSprite(const std::string& file, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) override {
+				const auto it = _handleMap.find(file);
+				if ( it != _handleMap.end() )
+					drawSprite( it->second, srcBBox, dstBBox, color );
+			}
+
+			virtual void drawText(const UIString& text, const Vec2& pos, const float scale, const Utils::Color color) override {
+				_drawGlyphRun( *_getGlyphRun(text, scale), pos, color );
+			}
+			/// the whole block is one cached run
+			virtual void drawTextBlock(const UIString& text, const Vec2& pos, const float lineHeight, const float scale, const Utils::Color color) override {
+				_drawGlyphRun( *_getGlyphRun(text, scale, lineHeight > 0 ? lineHeight : (float)CellHeight * scale), pos, color );
+			}
+			virtual void drawText(const std::string& text, const Vec2& pos, const float scale, const Utils::Color color) override {
+				drawText( UIString(text), pos, scale, color );
+			}
+
+			virtual bool measureText(const UIString& text, const float scale, Vec2& outSize) override {
+				outSize = _getGlyphRun(text, scale)->size;
+				return true;
+			}
+			/// monospace, nothing to lay out or cache
+			virtual bool measureText(const std::string& text, const float scale, Vec2& outSize) override {
+				outSize = Vec2{ (float)( CellWidth * text.size() ) * scale, (float)CellHeight * scale };
+				return true;
+			}
+
+			UIGlyphRunCache& getGlyphRunCacheRef() { return _glyphRunCache; }
+
+			virtual void setClipRect(const BBox& clipBBox) override {
+				_target.clip    = clipBBox;
+				_target.hasClip = true;
+			}
+			virtual void clearClipRect() override {
+				_target.hasClip = false;
+			}
+
+			/// layers are images without a path, their pixels are freed on release and the handle reused
+			virtual UIResourceHandle createLayer() override {
+				if ( _freeLayerList.size() ) {
+					const auto handle = _freeLayerList.back();
+					_freeLayerList.pop_back();
+					return handle;
+				}
+
+				_imageList.emplace_back();
+				return (UIResourceHandle)_imageList.size();
+			}
+			virtual void releaseLayer(const UIResourceHandle handle) override {
+				if ( !handle || handle > _imageList.size() )
+					return;
+
+				_imageList[ handle - 1 ] = TImage{};
+				_freeLayerList.push_back(handle);
+			}
+			virtual void beginLayer(const UIResourceHandle handle, const BBox& bbox) override {
+				if ( !handle || handle > _imageList.size() )
+					return;
+
+				auto& image = _imageList[ handle - 1 ];
+				image.width  = (int32_t)std::ceil( bbox.getWidth () );
+				image.height = (int32_t)std::ceil( bbox.getHeight() );
+				image.width  = image.width  > 0 ? image.width  : 0;
+				image.height = image.height > 0 ? image.height : 0;
+				image.pixelList.assign( (size_t)image.width * image.height, 0 );
+
+				_layerStack.push_back(_target);
+				_target = TTarget{ image.pixelList.data(), image.width, image.height, bbox.min };
+			}
+			virtual void endLayer() override {
+				if ( _layerStack.empty() )
+					return;
+
+				_target = _layerStack.back();
+				_layerStack.pop_back();
+			}
+
+			/// binary P6, alpha dropped
+			void encodePPM(std::vector< uint8_t >& out) const {
+				const auto header = "P6\n" + std::to_string(_width) + " " + std::to_string(_height) + "\n255\n";
+				out.assign( header.begin(), header.end() );
+				out.reserve( out.size() + _pixelList.size() * 3 );
+				for(const auto pixel : _pixelList) {
+					out.push_back( pixel       );
+					out.push_back( pixel >>  8 );
+					out.push_back( pixel >> 16 );
+				}
+			}
+
+			/// RGBA PNG, premultiplied pixels are written back straight. Stored deflate blocks, no compression.
+			void encodePNG(std::vector< uint8_t >& out) const {
+				std::vector< uint8_t > raw;
+				raw.reserve( (size_t)_height * ( 1 + _width * 4 ) );
+				for(int32_t y = 0; y < _height; y++) {
+					raw.push_back(0);
+					for(int32_t x = 0; x < _width; x++) {
+						const uint32_t pixel = _pixelList[ y * _width + x ];
+						const uint32_t a     = pixel >> 24;
+						for(uint32_t shift = 0; shift < 24; shift += 8) {
+							const uint32_t c = a ? ( ( ( pixel >> shift ) & 0xFF ) * 255 + a / 2 ) / a : 0;
+							raw.push_back( c > 255 ? 255 : c );
+						}
+						raw.push_back(a);
+					}
+				}
+
+				std::vector< uint8_t > zlib = { 0x78, 0x01 };
+				size_t pos = 0;
+				do {
+					const size_t   size = raw.size() - pos < 0xFFFF ? raw.size() - pos : 0xFFFF;
+					const uint16_t len  = (uint16_t)size;
+					zlib.push_back( ( pos + size == raw.size() ) ? 1 : 0 );
+					zlib.push_back( len & 0xFF );
+					zlib.push_back( len >> 8 );
+					zlib.push_back( ~len & 0xFF );
+					zlib.push_back( ( ~len >> 8 ) & 0xFF );
+					zlib.insert( zlib.end(), raw.begin() + pos, raw.begin() + pos + size );
+					pos += size;
+				} while( pos < raw.size() );
+
+				uint32_t s1 = 1;
+				uint32_t s2 = 0;
+				for(const auto byte : raw) {
+					s1 = ( s1 + byte ) % 65521;
+					s2 = ( s2 + s1   ) % 65521;
+				}
+				_putU32BE( zlib, ( s2 << 16 ) | s1 );
+
+				std::vector< uint8_t > header;
+				_putU32BE( header, _width  );
+				_putU32BE( header, _height );
+				header.insert( header.end(), { 8, 6, 0, 0, 0 } );
+
+				static const uint8_t sSignature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+				out.assign( sSignature, sSignature + sizeof(sSignature) );
+				_putChunk( out, "IHDR", header );
+				_putChunk( out, "IDAT", zlib   );
+				_putChunk( out, "IEND", {}     );
+			}
+
+			bool savePPM(const std::string& path) const {
+				std::vector< uint8_t > data;
+				encodePPM(data);
+				return _saveFile(path, data);
+			}
+			bool savePNG(const std::string& path) const {
+				std::vector< uint8_t > data;
+				encodePNG(data);
+				return _saveFile(path, data);
+			}
+
+			static std::shared_ptr< UIRenderDriverSoftware > create(const int32_t width, const int32_t height) {
+				return std::make_shared< UIRenderDriverSoftware >(width, height);
+			}
+	};
+	using SP_UIRenderDriverSoftware = std::shared_ptr< UIRenderDriverSoftware >;
+
+}
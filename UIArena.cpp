@@ -0,0 +1,148 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// Per-document bump allocator. The nodes, envs and vars of one document, and the UINodeDesc tree
+	/// parsed into it, are carved out of fixed size blocks. Freeing one of them does nothing; destroying
+	/// the arena hands all of its blocks in one go to a process-wide cache that the next document takes
+	/// them from, so neither teardown nor the next load touches the system allocator for them.
+	/// Objects hold no reference to the arena: the host owns it and drops it only after the document's
+	/// root node, envs, node desc and every UIVar taken from them. Memory of objects that die earlier
+	/// is not reused until then. Allocation is main thread only, like creating nodes and vars; freeing
+	/// does nothing, so the layout, record and render threads may drop the last reference to anything.
+	///
+	///		auto spArena = UIArena::create();
+	///		auto parsed  = Parser::parse( text, spArena.get() );
+	///		auto root    = createUINode( parsed.result, UIVarEnv::createWithArena( spArena.get() ) );
+	///		...
+	///		root    = nullptr;
+	///		parsed  = {};
+	///		spArena = nullptr;   // the whole document in one release
+	class UIArena {
+		private:
+			static constexpr size_t BlockSize = 64 * 1024;
+
+			struct TBlockCache {
+				std::mutex           mutex;
+				std::vector< void* > blockList;
+			};
+			/// never destroyed, arenas may outlive static destruction order
+			static TBlockCache& _getBlockCache() {
+				static TBlockCache* pCache = new TBlockCache();
+				return *pCache;
+			}
+
+			std::vector< void* > _blockList;
+			/// allocations over a quarter block get a block of their own, freed with the arena instead of cached
+			std::vector< void* > _largeBlockList;
+			uint8_t*             _pHead = nullptr;
+			uint8_t*             _pEnd  = nullptr;
+
+			static uint8_t* _alignUp(uint8_t* p, const size_t align) {
+				return (uint8_t*)( ( (uintptr_t)p + align - 1 ) & ~(uintptr_t)( align - 1 ) );
+			}
+
+			void* _allocateLarge(const size_t size, const size_t align) {
+				auto* pBlock = (uint8_t*)std::malloc( size + align );
+				if ( !pBlock )
+					throw std::bad_alloc();
+				_largeBlockList.push_back(pBlock);
+				return _alignUp(pBlock, align);
+			}
+			void _nextBlock() {
+				void* pBlock = nullptr;
+				{
+					auto& cache = _getBlockCache();
+					std::lock_guard< std::mutex > lock(cache.mutex);
+					if ( cache.blockList.size() ) {
+						pBlock = cache.blockList.back();
+						cache.blockList.pop_back();
+					}
+				}
+				if ( !pBlock )
+					pBlock = std::malloc(BlockSize);
+				if ( !pBlock )
+					throw std::bad_alloc();
+
+				_blockList.push_back(pBlock);
+				_pHead = (uint8_t*)pBlock;
+				_pEnd  = _pHead + BlockSize;
+			}
+
+		public:
+			UIArena() = default;
+			UIArena(const UIArena&) = delete;
+			UIArena& operator =(const UIArena&) = delete;
+			~UIArena() {
+				for(auto* pBlock : _largeBlockList)
+					std::free(pBlock);
+
+				auto& cache = _getBlockCache();
+				std::lock_guard< std::mutex > lock(cache.mutex);
+				cache.blockList.insert( cache.blockList.end(), _blockList.begin(), _blockList.end() );
+			}
+
+			void* allocate(const size_t size, const size_t align) {
+				if ( size + align > BlockSize / 4 )
+					return _allocateLarge(size, align);
+
+				auto* p = _alignUp(_pHead, align);
+				if ( !_pHead || p + size > _pEnd ) {
+					_nextBlock();
+					p = _alignUp(_pHead, align);
+				}
+				_pHead = p + size;
+				return p;
+			}
+
+			size_t getBlockCount() const { return _blockList.size() + _largeBlockList.size(); }
+
+			/// gives the cached blocks of destroyed arenas back to the system, e.g. after leaving a large screen for good
+			static void trimBlockCache() {
+				auto& cache = _getBlockCache();
+				std::lock_guard< std::mutex > lock(cache.mutex);
+				for(auto* pBlock : cache.blockList)
+					std::free(pBlock);
+				cache.blockList.clear();
+				cache.blockList.shrink_to_fit();
+			}
+
+			static std::shared_ptr< UIArena > create() {
+				return std::make_shared< UIArena >();
+			}
+	};
+	using SP_UIArena = std::shared_ptr< UIArena >;
+
+	template< class T >
+	class UIArenaAllocator {
+		template< class U > friend class UIArenaAllocator;
+
+		private:
+			UIArena* _pArena;
+
+		public:
+			using value_type = T;
+
+			UIArenaAllocator(UIArena* pArena) : _pArena(pArena) {}
+			template< class U >
+			UIArenaAllocator(const UIArenaAllocator< U >& other) : _pArena(other._pArena) {}
+
+			T*   allocate  (const size_t n)       { return (T*)_pArena->allocate( n * sizeof(T), alignof(T) ); }
+			void deallocate(T* p, const size_t n) {}
+
+			template< class U >
+			bool operator ==(const UIArenaAllocator< U >& other) const { return _pArena == other._pArena; }
+			template< class U >
+			bool operator !=(const UIArenaAllocator< U >& other) const { return _pArena != other._pArena; }
+	};
+
+	/// make_shared when pArena is null, so the default path is unchanged
+	template< class T, class... TArgs >
+	std::shared_ptr< T > arenaMakeShared(UIArena* pArena, TArgs&&... args) {
+		if ( !pArena )
+			return std::make_shared< T >( std::forward< TArgs >(args)... );
+
+		return std::allocate_shared< T >( UIArenaAllocator< T >(pArena), std::forward< TArgs >(args)... );
+	}
+
+}
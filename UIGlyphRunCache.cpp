@@ -0,0 +1,116 @@
+#pragma once
+
+#include <list>
+
+namespace UIMiniEmbed {
+
+	/// One quad of a laid out string, dstBBox relative to the pen position drawText gets
+	struct UIGlyphQuad {
+		BBox srcBBox;
+		BBox dstBBox;
+	};
+
+	struct UIGlyphRun {
+		std::vector< UIGlyphQuad > quadList;
+		Vec2                       size;
+	};
+	using SP_UIGlyphRun = std::shared_ptr< const UIGlyphRun >;
+
+	/// Laid out strings keyed by interned text, scale, line advance and font, shared by every label showing them.
+	/// A line advance of 0 is a single line, text blocks break at '\n' and advance by it.
+	/// Least recently used runs are dropped once their bytes exceed the budget. A run handed out stays
+	/// valid after eviction, the cache only drops its own reference.
+	///
+	///		auto spRun = cache.get( text, scale, fontId, [&](UIGlyphRun& run) { ...fill run... } );
+	class UIGlyphRunCache {
+		private:
+			struct TKey {
+				const void* text;
+				float       scale;
+				float       lineHeight;
+				uint32_t    font;
+
+				bool operator == (const TKey& other) const { return text == other.text && scale == other.scale && lineHeight == other.lineHeight && font == other.font; }
+			};
+			struct TKeyHash {
+				size_t operator()(const TKey& key) const {
+					return std::hash< const void* >()(key.text) ^ ( std::hash< float >()(key.scale) * 31 ) ^ ( std::hash< float >()(key.lineHeight) * 131 ) ^ ( (size_t)key.font << 17 );
+				}
+			};
+			struct TEntry {
+				TKey          key;
+				/// keeps key.text alive
+				UIString      text;
+				SP_UIGlyphRun spRun;
+				size_t        bytes;
+			};
+			using TList = std::list< TEntry >;
+
+			size_t _budget;
+			size_t _bytes     = 0;
+			size_t _hits      = 0;
+			size_t _misses    = 0;
+			size_t _evictions = 0;
+
+			TList                                                   _list;
+			std::unordered_map< TKey, TList::iterator, TKeyHash >   _map;
+
+			void _trim() {
+				/// the newest run stays even when it is over the budget alone
+				while( _bytes > _budget && _list.size() > 1 ) {
+					auto& entry = _list.back();
+					_bytes -= entry.bytes;
+					_map.erase(entry.key);
+					_list.pop_back();
+					_evictions++;
+				}
+			}
+
+		public:
+			UIGlyphRunCache(const size_t budget = 256 * 1024) : _budget(budget) {}
+
+			template< class TBuild >
+			SP_UIGlyphRun get(const UIString& text, const float scale, const uint32_t font, TBuild&& build) {
+				return get( text, scale, 0.0f, font, std::forward< TBuild >(build) );
+			}
+			template< class TBuild >
+			SP_UIGlyphRun get(const UIString& text, const float scale, const float lineHeight, const uint32_t font, TBuild&& build) {
+				const auto key = TKey{ text.getId(), scale, lineHeight, font };
+				const auto it  = _map.find(key);
+				if ( it != _map.end() ) {
+					_hits++;
+					_list.splice( _list.begin(), _list, it->second );
+					return it->second->spRun;
+				}
+
+				_misses++;
+				auto spRun = std::make_shared< UIGlyphRun >();
+				build(*spRun);
+
+				const size_t bytes = sizeof(TEntry) + sizeof(UIGlyphRun) + spRun->quadList.capacity() * sizeof(UIGlyphQuad);
+				_list.push_front( TEntry{ key, text, spRun, bytes } );
+				_map.emplace( key, _list.begin() );
+				_bytes += bytes;
+				_trim();
+				return spRun;
+			}
+
+			void setBudget(const size_t budget) {
+				_budget = budget;
+				_trim();
+			}
+			void clear() {
+				_list.clear();
+				_map.clear();
+				_bytes = 0;
+			}
+
+			size_t getBudget       () const { return _budget;      }
+			size_t getBytes        () const { return _bytes;       }
+			size_t getSize         () const { return _list.size(); }
+			size_t getHitCount     () const { return _hits;        }
+			size_t getMissCount    () const { return _misses;      }
+			size_t getEvictionCount() const { return _evictions;   }
+	};
+
+}
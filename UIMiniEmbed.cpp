@@ -1,37 +1,57 @@
 #pragma once
 
 #include "Utils.cpp"
+#include "UISimd.cpp"
+#include "UIString.cpp"
+#include "UIArena.cpp"
+#include "UIWorkPool.cpp"
 #include "Loop.cpp"
 #include "UIVar.cpp"
 #include "UINodeDesc.cpp"
 #include "Parser.cpp"
+#include "UIRenderCommandBuffer.cpp"
+#include "UIRenderBatcher.cpp"
+#include "UIRenderVertexStream.cpp"
+#include "UIGlyphRunCache.cpp"
+#include "UISpriteAtlas.cpp"
 #include "UIRenderDriverApi.cpp"
+#include "UIRenderPipeline.cpp"
+#include "UISpritePreload.cpp"
 #include "UIInputMouse.cpp"
 #include "UIStyle.cpp"
 
 #include "BaseComponent/UIComponent.cpp"
+#include "BaseComponent/UILayoutFlat.cpp"
+#include "BaseComponent/UILayoutParallel.cpp"
+#include "BaseComponent/UIRecordParallel.cpp"
 #include "Components/MouseLogic.cpp"
 #include "Components/Logic.cpp"
 #include "Components/TextLine.cpp"
+#include "Components/TextBlock.cpp"
 #include "Components/Sprite.cpp"
+#include "Components/VirtualList.cpp"
+
+#include "RenderDrivers/UIRenderDriverSoftware.cpp"
+#include "RenderDrivers/UIRenderDriverCapture.cpp"
 
 namespace UIMiniEmbed {
 
 	struct T_createUINode {
 		SP_UINodeDesc  spNodeDesc;
+		UIArena*       pArena;
 		SP_UIComponent node = nullptr;
 			
 		template< class T >
 		void make(const std::string& name) {
 			if ( spNodeDesc->getComponentName() == name )
-				node = std::make_shared< T >();
+				node = arenaMakeShared< T >(pArena);
 		}
 	};
 	SP_UIComponent createUINode(SP_UINodeDesc spNodeDesc, SP_UIVarEnv spVarEnv, SP_UIComponent spParentNode) {
 		if ( !spVarEnv )
 			spVarEnv = UIVarEnv::create();
 		
-		auto un = T_createUINode{ spNodeDesc };
+		auto un = T_createUINode{ spNodeDesc, spVarEnv->getArena() };
 		un.make< UIComponentRoot                 >("Root");
 		un.make< UIComponentContainer            >("Container");
 		un.make< UIComponentContainerTransparent >("ContainerTransparent");
@@ -39,9 +59,12 @@ namespace UIMiniEmbed {
  
 		un.make< UIComponent_TextLineDumpVar      >("TextLineDumpVar");
 		un.make< UIComponent_TextLine             >("TextLine");
+		un.make< UIComponent_TextBlock            >("TextBlock");
 		un.make< UIComponent_Sprite               >("Sprite");
 		un.make< UIComponent_SpriteFrameAnimation >("SpriteFrameAnimation");
 
+		un.make< UIComponent_VirtualList          >("VirtualList");
+
 		un.make< UIComponent_If                  >("if");
 		un.make< UIComponent_IfNot               >("ifnot");
 		
@@ -61,7 +84,7 @@ namespace UIMiniEmbed {
 		un.make< UIComponent_ClickL              >("lclick");
 
 		if ( !un.node )
-			un.node = std::make_shared< UIComponentContainer >();
+			un.node = arenaMakeShared< UIComponentContainer >(un.pArena);
 		
 		un.node->create(spNodeDesc, spVarEnv, spParentNode);
 		
@@ -124,7 +124,8 @@ namespace UIMiniEmbed {
 				bool isError() { return errorText.length(); }
 			};
 			
-			SP_UINodeDesc buildAliasSelf(TBuildAliasError& outError,  UINodeAliasDescMap& aliasMap, const std::unordered_set< std::string >& aliasSet = {}) {
+			/// the returned tree comes from pArena when it is set, the nodes in between do not
+			SP_UINodeDesc buildAliasSelf(TBuildAliasError& outError,  UINodeAliasDescMap& aliasMap, const std::unordered_set< std::string >& aliasSet = {}, UIArena* pArena = nullptr) {
 				const auto componentName = getComponentName();
 				
 				auto aliasNode = aliasMap.get( componentName );
@@ -142,19 +143,19 @@ namespace UIMiniEmbed {
 					
 					aliasSetCopy.insert( componentName );
 					
-					return aliasNode->clone(_props)->buildAliasSelf(outError,  aliasMap, aliasSetCopy);
+					return aliasNode->clone(_props)->buildAliasSelf(outError,  aliasMap, aliasSetCopy, pArena);
 				}
 				
 				UINodeDescList childNodes;
 				for(auto childNode : _childNodes) {
-					auto newChildNode = childNode->buildAliasSelf(outError,  aliasMap, aliasSet);
+					auto newChildNode = childNode->buildAliasSelf(outError,  aliasMap, aliasSet, pArena);
 					if ( !newChildNode )
 						return nullptr;
 					
 					childNodes.push_back( newChildNode );
 				}
 				
-				return create(componentName, _props, { childNodes });
+				return create(componentName, _props, { childNodes }, pArena);
 			}
 			void clearAlias() {
 				_aliasMap.clear();
@@ -192,9 +193,26 @@ namespace UIMiniEmbed {
 			UINodePropDescList    getProps        () const { return _props; }
 			UINodeDescList        getChildNodes   () const { return _childNodes; }
 			const UINodeDescList& getChildNodesRef() const { return _childNodes; }
+			
+			/// Calls fn for this node, the bodies of its aliases and its children, depth first.
+			/// Every child is visited whatever the component does with it, aliases go in name order.
+			template< class TFn >
+			void walk(TFn&& fn) const {
+				fn(*this);
+				
+				std::vector< const std::pair< const std::string, SP_UINodeDesc >* > aliasList;
+				for(const auto& rec : _aliasMap._map)
+					aliasList.push_back(&rec);
+				std::sort( aliasList.begin(), aliasList.end(), [](const auto* a, const auto* b) { return a->first < b->first; } );
+				
+				for(const auto* pRec : aliasList)
+					pRec->second->walk(fn);
+				for(const auto& childNode : _childNodes)
+					childNode->walk(fn);
+			}
 		
-			static SP_UINodeDesc create(const std::string& name, UINodePropDescList props, UINodeChildrenGroup childGroup) {
-				auto sp = std::make_shared< UINodeDesc >();
+			static SP_UINodeDesc create(const std::string& name, UINodePropDescList props, UINodeChildrenGroup childGroup, UIArena* pArena = nullptr) {
+				auto sp = arenaMakeShared< UINodeDesc >(pArena);
 				sp->_componentName = name;
 				sp->_props = props;
 				sp->_childNodes = childGroup.nodeDescList;
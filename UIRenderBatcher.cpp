@@ -0,0 +1,155 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// A run of commands drawn with one texture, or a single clip or layer command
+	struct UIRenderBatch {
+		UIRenderCommand::EnumType type     = UIRenderCommand::Sprite;
+		UIResourceHandle          handle   = 0;
+		uint32_t                  first    = 0;
+		uint32_t                  count    = 0;
+	};
+
+	struct UIRenderBatchStats {
+		size_t commandCount            = 0;
+		size_t batchCount              = 0;
+		/// texture changes between consecutive draws, in recorded and in batched order
+		size_t stateChangeCount        = 0;
+		size_t batchedStateChangeCount = 0;
+	};
+
+	/// Regroups a recorded frame into per-texture runs without changing what ends up on screen.
+	/// A draw moves back into an earlier run of its texture only when it overlaps nothing recorded in
+	/// between, so draws that cover each other keep their order. Clip and layer commands are barriers.
+	/// Text shares one run key, path sprites are keyed by path and handle sprites by handle.
+	///
+	///		batcher.build( root->getDrawListRef() );
+	///		api->submitBatched( root->getDrawListRef(), batcher );
+	class UIRenderBatcher {
+		private:
+			struct TKey {
+				UIRenderCommand::EnumType type;
+				UIResourceHandle          handle;
+				const void*               resource;
+
+				bool operator == (const TKey& other) const { return type == other.type && handle == other.handle && resource == other.resource; }
+				bool operator != (const TKey& other) const { return !( *this == other ); }
+			};
+			struct TOpenBatch {
+				TKey                     key;
+				BBox                     bounds;
+				std::vector< uint32_t >  indexList;
+			};
+
+			/// how many open runs a draw looks back through for its texture
+			size_t                          _searchDepth;
+
+			std::vector< TOpenBatch >       _openList;
+			std::vector< UIRenderCommand >  _commandList;
+			std::vector< UIRenderBatch >    _batchList;
+			UIRenderBatchStats              _stats;
+
+			static TKey _getKey(const UIRenderCommandBuffer& cmdBuffer, const UIRenderCommand& cmd) {
+				/// lines and blocks share the font
+				if ( cmd.isText() )
+					return TKey{ UIRenderCommand::Text, 0, nullptr };
+				if ( cmd.handle )
+					return TKey{ cmd.type, cmd.handle, nullptr };
+				return TKey{ cmd.type, 0, cmdBuffer.getString(cmd.resource).getId() };
+			}
+
+			static BBox _union(const BBox& a, const BBox& b) {
+				return BBox{
+					Vec2{ a.min.x < b.min.x ? a.min.x : b.min.x, a.min.y < b.min.y ? a.min.y : b.min.y },
+					Vec2{ a.max.x > b.max.x ? a.max.x : b.max.x, a.max.y > b.max.y ? a.max.y : b.max.y },
+				};
+			}
+
+			void _flush(const UIRenderCommandBuffer& cmdBuffer) {
+				const auto& srcList = cmdBuffer.getCommandListRef();
+				for(auto& open : _openList) {
+					UIRenderBatch batch;
+					batch.type   = open.key.type;
+					batch.handle = open.key.handle;
+					batch.first  = (uint32_t)_commandList.size();
+					batch.count  = (uint32_t)open.indexList.size();
+					for(const auto index : open.indexList)
+						_commandList.push_back( srcList[index] );
+					_batchList.push_back(batch);
+				}
+				_openList.clear();
+			}
+
+		public:
+			UIRenderBatcher(const size_t searchDepth = 64) : _searchDepth(searchDepth) {}
+
+			void build(const UIRenderCommandBuffer& cmdBuffer) {
+				const auto& srcList = cmdBuffer.getCommandListRef();
+
+				_openList   .clear();
+				_commandList.clear();
+				_batchList  .clear();
+				_stats = UIRenderBatchStats{};
+				_stats.commandCount = srcList.size();
+
+				bool hasPrevKey = false;
+				TKey prevKey{};
+				for(uint32_t i = 0; i < srcList.size(); i++) {
+					const auto& cmd = srcList[i];
+					if ( !cmd.isDraw() ) {
+						_flush(cmdBuffer);
+						_commandList.push_back(cmd);
+						_batchList.push_back( UIRenderBatch{ cmd.type, cmd.handle, (uint32_t)_commandList.size() - 1, 1 } );
+						continue;
+					}
+
+					const auto key = _getKey(cmdBuffer, cmd);
+					if ( hasPrevKey && key != prevKey )
+						_stats.stateChangeCount++;
+					hasPrevKey = true;
+					prevKey    = key;
+
+					/// the newest run of this texture that no later run overlaps, bounds are unions so this is conservative
+					TOpenBatch* pTarget = nullptr;
+					const size_t depth = _openList.size() < _searchDepth ? _openList.size() : _searchDepth;
+					for(size_t k = 0; k < depth; k++) {
+						auto& open = _openList[ _openList.size() - 1 - k ];
+						if ( open.key == key ) {
+							pTarget = &open;
+							break;
+						}
+						if ( open.bounds.isIntersect(cmd.dstBBox) )
+							break;
+					}
+
+					if ( !pTarget ) {
+						_openList.push_back( TOpenBatch{ key, cmd.dstBBox, {} } );
+						pTarget = &_openList.back();
+					} else {
+						pTarget->bounds = _union( pTarget->bounds, cmd.dstBBox );
+					}
+					pTarget->indexList.push_back(i);
+				}
+				_flush(cmdBuffer);
+
+				hasPrevKey = false;
+				for(const auto& batch : _batchList) {
+					if ( batch.type != UIRenderCommand::Sprite && batch.type != UIRenderCommand::Text )
+						continue;
+
+					const auto key = _getKey( cmdBuffer, _commandList[batch.first] );
+					if ( hasPrevKey && key != prevKey )
+						_stats.batchedStateChangeCount++;
+					hasPrevKey = true;
+					prevKey    = key;
+				}
+				_stats.batchCount = _batchList.size();
+			}
+
+			/// the recorded commands in batched order, string indices still refer to the built buffer
+			const std::vector< UIRenderCommand >& getCommandListRef() const { return _commandList; }
+			const std::vector< UIRenderBatch >&   getBatchListRef  () const { return _batchList;   }
+			const UIRenderBatchStats&             getStatsRef      () const { return _stats;       }
+	};
+
+}
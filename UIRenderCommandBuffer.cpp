@@ -0,0 +1,414 @@
+#pragma once
+
+#include <cstring>
+
+namespace UIMiniEmbed {
+
+	/// Driver side id of a texture or other resource, see UIRenderDriverApi::resolveResource. 0 is none.
+	using UIResourceHandle = uint32_t;
+
+	/// One recorded draw. Plain data, strings are indices into the buffer's string table.
+	struct UIRenderCommand {
+		enum EnumType : uint8_t {
+			Sprite,     /// handle, or resource: path when handle is 0,  srcBBox -> dstBBox
+			Text,       /// resource: text,  drawn at dstBBox.min, dstBBox is the laid out box
+			TextBlock,  /// resource: lines joined by '\n',  line i drawn at dstBBox.min + ( 0, i * srcBBox.max.y )
+			Clip,       /// dstBBox: scissor for the commands that follow
+			ClipReset,  /// no scissor
+			LayerBegin, /// handle: layer,  dstBBox: its box on screen, the commands up to LayerEnd render into it
+			LayerEnd,
+		};
+		enum EnumFlag : uint8_t {
+			FlagOpaque = 1,  /// dstBBox is fully covered with opaque pixels, recorded for opaque nodes at opacity 1
+		};
+
+		EnumType         type     = Sprite;
+		uint8_t          flags    = 0;
+		uint32_t         resource = 0;
+		UIResourceHandle handle   = 0;
+		float            scale    = 1;
+		Utils::Color     color;
+		BBox             srcBBox;
+		BBox             dstBBox;
+		
+		bool isDraw() const { return type == Sprite || type == Text || type == TextBlock; }
+		bool isText() const { return type == Text || type == TextBlock; }
+	};
+
+	/// Everything drawAll() produced for one frame, handed to UIRenderDriverApi::submit() in one call
+	class UIRenderCommandBuffer {
+		private:
+			std::vector< UIRenderCommand >             _commandList;
+			std::vector< UIString >                    _stringList;
+			std::unordered_map< const void*, uint32_t > _stringIndexMap;
+
+		public:
+			void clear() {
+				_commandList   .clear();
+				_stringList    .clear();
+				_stringIndexMap.clear();
+			}
+
+			/// equal strings share one index for the lifetime of the recording
+			uint32_t addString(const UIString& str) {
+				const auto it = _stringIndexMap.find( str.getId() );
+				if ( it != _stringIndexMap.end() )
+					return it->second;
+
+				const auto index = (uint32_t)_stringList.size();
+				_stringList.push_back(str);
+				_stringIndexMap.emplace( str.getId(), index );
+				return index;
+			}
+
+			/// a resolved handle skips the string table
+			void addSprite(const UIString& path, const UIResourceHandle handle, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) {
+				UIRenderCommand cmd;
+				cmd.type     = UIRenderCommand::Sprite;
+				cmd.handle   = handle;
+				if ( !handle )
+					cmd.resource = addString(path);
+				cmd.color    = color;
+				cmd.srcBBox  = srcBBox;
+				cmd.dstBBox  = dstBBox;
+				_commandList.push_back(cmd);
+			}
+			void addText(const UIString& text, const BBox& dstBBox, const float scale, const Utils::Color color) {
+				UIRenderCommand cmd;
+				cmd.type     = UIRenderCommand::Text;
+				cmd.resource = addString(text);
+				cmd.scale    = scale;
+				cmd.color    = color;
+				cmd.dstBBox  = dstBBox;
+				_commandList.push_back(cmd);
+			}
+			/// srcBBox carries the line advance, text blocks have no source box
+			void addTextBlock(const UIString& text, const BBox& dstBBox, const float lineHeight, const float scale, const Utils::Color color) {
+				UIRenderCommand cmd;
+				cmd.type     = UIRenderCommand::TextBlock;
+				cmd.resource = addString(text);
+				cmd.scale    = scale;
+				cmd.color    = color;
+				cmd.srcBBox  = BBox{ {}, Vec2{ 0, lineHeight } };
+				cmd.dstBBox  = dstBBox;
+				_commandList.push_back(cmd);
+			}
+			void addClip(const BBox& clipBBox) {
+				UIRenderCommand cmd;
+				cmd.type    = UIRenderCommand::Clip;
+				cmd.dstBBox = clipBBox;
+				_commandList.push_back(cmd);
+			}
+			void addClipReset() {
+				UIRenderCommand cmd;
+				cmd.type = UIRenderCommand::ClipReset;
+				_commandList.push_back(cmd);
+			}
+			void addLayerBegin(const UIResourceHandle handle, const BBox& dstBBox) {
+				UIRenderCommand cmd;
+				cmd.type    = UIRenderCommand::LayerBegin;
+				cmd.handle  = handle;
+				cmd.dstBBox = dstBBox;
+				_commandList.push_back(cmd);
+			}
+			void addLayerEnd() {
+				UIRenderCommand cmd;
+				cmd.type = UIRenderCommand::LayerEnd;
+				_commandList.push_back(cmd);
+			}
+			/// a layer drawn to the screen is a handle sprite, resource carries its content version for damage
+			void addLayer(const UIResourceHandle handle, const uint32_t version, const BBox& dstBBox, const Utils::Color color) {
+				UIRenderCommand cmd;
+				cmd.type     = UIRenderCommand::Sprite;
+				cmd.handle   = handle;
+				cmd.resource = version;
+				cmd.color    = color;
+				cmd.srcBBox  = BBox{ {}, Vec2{ dstBBox.getWidth(), dstBBox.getHeight() } };
+				cmd.dstBBox  = dstBBox;
+				_commandList.push_back(cmd);
+			}
+			
+			/// flags every sprite recorded since the command list had firstCommand entries
+			void markOpaque(const size_t firstCommand) {
+				for(size_t i = firstCommand; i < _commandList.size(); i++)
+					if ( _commandList[i].type == UIRenderCommand::Sprite )
+						_commandList[i].flags |= UIRenderCommand::FlagOpaque;
+			}
+			
+			/// outStringMap[i] is this buffer's index for string i of other, see append
+			void mapStrings(const UIRenderCommandBuffer& other, std::vector< uint32_t >& outStringMap) {
+				outStringMap.resize( other._stringList.size() );
+				for(size_t i = 0; i < other._stringList.size(); i++)
+					outStringMap[i] = addString( other._stringList[i] );
+			}
+			/// appends commands [first, last) of other with their strings moved to this buffer's table
+			void append(const UIRenderCommandBuffer& other, const std::vector< uint32_t >& stringMap, const size_t first, const size_t last) {
+				_commandList.insert( _commandList.end(), other._commandList.begin() + first, other._commandList.begin() + last );
+				for(size_t i = _commandList.size() - ( last - first ); i < _commandList.size(); i++) {
+					auto& cmd = _commandList[i];
+					if ( cmd.isText() || ( cmd.type == UIRenderCommand::Sprite && !cmd.handle ) )
+						cmd.resource = stringMap[ cmd.resource ];
+				}
+			}
+			
+			/// drops every command whose entry in removeList is set, the string table is kept
+			void removeCommands(const std::vector< uint8_t >& removeList) {
+				size_t count = 0;
+				for(size_t i = 0; i < _commandList.size(); i++)
+					if ( !removeList[i] )
+						_commandList[count++] = _commandList[i];
+				_commandList.resize(count);
+			}
+
+			const std::vector< UIRenderCommand >& getCommandListRef() const { return _commandList; }
+			const std::vector< UIString >&        getStringListRef () const { return _stringList;  }
+			const UIString&                       getString(const uint32_t index) const { return _stringList[index]; }
+	};
+	using SP_UIRenderCommandBuffer = std::shared_ptr< UIRenderCommandBuffer >;
+	
+	/// Drops draws that later opaque draws cover completely, walking the frame from the top down.
+	/// Each draw is tested as its dstBBox cut by its scissor. Only the first maxOccluders opaque rects
+	/// met from the top are kept as occluders. Draws into layers are left alone, the layer keeps them.
+	/// Text is never removed nor occludes, glyphs may reach past its dstBBox.
+	class UIRenderOcclusion {
+		private:
+			size_t                 _maxOccluders;
+			std::vector< BBox >    _rectList;
+			std::vector< BBox >    _occluderList;
+			std::vector< uint8_t > _removeList;
+			
+			static bool _contains(const BBox& outer, const BBox& inner) {
+				return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.max.x >= inner.max.x && outer.max.y >= inner.max.y;
+			}
+			
+		public:
+			UIRenderOcclusion(const size_t maxOccluders = 32) : _maxOccluders(maxOccluders) {}
+			
+			/// returns how many commands were removed
+			size_t apply(UIRenderCommandBuffer& cmdBuffer) {
+				const auto& commandList = cmdBuffer.getCommandListRef();
+				
+				BBox   clip;
+				bool   hasClip    = false;
+				size_t layerDepth = 0;
+				_rectList.resize( commandList.size() );
+				_removeList.assign( commandList.size(), 0 );
+				for(size_t i = 0; i < commandList.size(); i++) {
+					const auto& cmd = commandList[i];
+					switch( cmd.type ) {
+						case UIRenderCommand::LayerBegin: layerDepth++; break;
+						case UIRenderCommand::LayerEnd  : layerDepth--; break;
+						case UIRenderCommand::Clip      : if ( !layerDepth ) { clip = cmd.dstBBox; hasClip = true; } break;
+						case UIRenderCommand::ClipReset : if ( !layerDepth ) hasClip = false; break;
+						default:
+							/// 1 keeps it out of both the occluders and the removal
+							if ( layerDepth || cmd.isText() )
+								_removeList[i] = 1;
+							_rectList[i] = hasClip ? cmd.dstBBox.intersect(clip) : cmd.dstBBox;
+					}
+				}
+				
+				size_t removed = 0;
+				_occluderList.clear();
+				for(size_t i = commandList.size(); i-- > 0; ) {
+					const auto& cmd = commandList[i];
+					if ( !cmd.isDraw() || _removeList[i] ) {
+						_removeList[i] = 0;
+						continue;
+					}
+					
+					const auto& rect = _rectList[i];
+					bool covered = false;
+					for(const auto& occluder : _occluderList)
+						if ( _contains(occluder, rect) ) {
+							covered = true;
+							break;
+						}
+					
+					if ( covered ) {
+						_removeList[i] = 1;
+						removed++;
+						continue;
+					}
+					
+					if ( ( cmd.flags & UIRenderCommand::FlagOpaque ) && rect.isValid() && _occluderList.size() < _maxOccluders )
+						_occluderList.push_back(rect);
+				}
+				
+				if ( removed )
+					cmdBuffer.removeCommands(_removeList);
+				return removed;
+			}
+	};
+	
+	/// Screen rectangles that differ between two recordings of a frame.
+	/// Draws are compared by content, not by string index, so the buffers may come from different recordings.
+	/// Clip commands are not compared themselves, every draw carries the scissor it was recorded under.
+	/// Draws into layers are skipped, a layer drawn to the screen carries its content version instead.
+	class UIRenderDamage {
+		private:
+			/// zero filled before use, compared with memcmp
+			struct TKey {
+				const void*      resource;
+				uint32_t         version;
+				UIResourceHandle handle;
+				uint32_t         type;
+				float            scale;
+				Utils::Color     color;
+				BBox             srcBBox;
+				BBox             dstBBox;
+				BBox             clip;
+				uint32_t         hasClip;
+			};
+			struct TEntry {
+				TKey key;
+				BBox rect;
+				
+				bool operator <  (const TEntry& other) const { return std::memcmp( &key, &other.key, sizeof(TKey) ) <  0; }
+				bool operator == (const TEntry& other) const { return std::memcmp( &key, &other.key, sizeof(TKey) ) == 0; }
+			};
+			
+			static void _buildEntryList(const UIRenderCommandBuffer& cmdBuffer, std::vector< TEntry >& outList) {
+				BBox   clip;
+				bool   hasClip    = false;
+				size_t layerDepth = 0;
+				
+				outList.clear();
+				for(const auto& cmd : cmdBuffer.getCommandListRef()) {
+					if ( cmd.type == UIRenderCommand::LayerBegin ) { layerDepth++; continue; }
+					if ( cmd.type == UIRenderCommand::LayerEnd   ) { layerDepth--; continue; }
+					if ( layerDepth )
+						continue;
+					
+					if ( cmd.type == UIRenderCommand::Clip      ) { clip = cmd.dstBBox; hasClip = true; continue; }
+					if ( cmd.type == UIRenderCommand::ClipReset ) { clip = BBox{};      hasClip = false; continue; }
+					
+					const bool hasString = cmd.isText() || !cmd.handle;
+					
+					TEntry entry;
+					std::memset( (void*)&entry.key, 0, sizeof(TKey) );
+					entry.key.resource = hasString ? cmdBuffer.getString(cmd.resource).getId() : nullptr;
+					entry.key.version  = hasString ? 0 : cmd.resource;
+					entry.key.handle   = cmd.handle;
+					entry.key.type     = cmd.type;
+					entry.key.scale    = cmd.scale;
+					entry.key.color    = cmd.color;
+					entry.key.srcBBox  = cmd.srcBBox;
+					entry.key.dstBBox  = cmd.dstBBox;
+					entry.key.clip     = clip;
+					entry.key.hasClip  = hasClip;
+					entry.rect         = hasClip ? cmd.dstBBox.intersect(clip) : cmd.dstBBox;
+					if ( entry.rect.isValid() )
+						outList.push_back(entry);
+				}
+			}
+			
+			static BBox _union(const BBox& a, const BBox& b) {
+				return BBox{
+					Vec2{ a.min.x < b.min.x ? a.min.x : b.min.x, a.min.y < b.min.y ? a.min.y : b.min.y },
+					Vec2{ a.max.x > b.max.x ? a.max.x : b.max.x, a.max.y > b.max.y ? a.max.y : b.max.y },
+				};
+			}
+			
+			/// overlapping rects are merged until none overlap, past maxRects everything becomes one box
+			static void _merge(std::vector< BBox >& rectList, const size_t maxRects) {
+				bool merged = true;
+				while( merged ) {
+					merged = false;
+					for(size_t i = 0; i < rectList.size(); i++)
+						for(size_t j = i + 1; j < rectList.size(); j++) {
+							if ( !rectList[i].isIntersect(rectList[j]) )
+								continue;
+							
+							rectList[i] = _union( rectList[i], rectList[j] );
+							rectList[j] = rectList.back();
+							rectList.pop_back();
+							merged = true;
+							j = i;
+						}
+				}
+				
+				if ( rectList.size() <= maxRects )
+					return;
+				
+				for(size_t i = 1; i < rectList.size(); i++)
+					rectList[0] = _union( rectList[0], rectList[i] );
+				rectList.resize(1);
+			}
+			
+			std::vector< TEntry >   _prevList;
+			std::vector< TEntry >   _nextList;
+			std::vector< uint32_t > _prevOrder;
+			std::vector< uint32_t > _nextOrder;
+			std::vector< uint8_t >  _prevMatched;
+			std::vector< uint8_t >  _nextMatched;
+			
+			static void _sortOrder(const std::vector< TEntry >& list, const size_t begin, const size_t end, std::vector< uint32_t >& outOrder) {
+				outOrder.clear();
+				for(size_t i = begin; i < end; i++)
+					outOrder.push_back( (uint32_t)i );
+				std::sort( outOrder.begin(), outOrder.end(), [&list](const uint32_t a, const uint32_t b) { return list[a] < list[b]; } );
+			}
+			
+		public:
+			/// Fills outList with the rects to redraw when going from prev to next, empty when both draw the same.
+			/// Unchanged leading and trailing draws are skipped. In the rest, draws found on one side only are
+			/// damaged, and so is every draw found on both sides whose place among the shared draws moved,
+			/// since the order decides what ends up on top.
+			void compute(const UIRenderCommandBuffer& prev, const UIRenderCommandBuffer& next, std::vector< BBox >& outList, const size_t maxRects = 16) {
+				outList.clear();
+				_buildEntryList(prev, _prevList);
+				_buildEntryList(next, _nextList);
+				
+				size_t begin    = 0;
+				size_t prevEnd  = _prevList.size();
+				size_t nextEnd  = _nextList.size();
+				while( begin < prevEnd && begin < nextEnd && _prevList[begin] == _nextList[begin] )
+					begin++;
+				while( prevEnd > begin && nextEnd > begin && _prevList[prevEnd - 1] == _nextList[nextEnd - 1] ) {
+					prevEnd--;
+					nextEnd--;
+				}
+				
+				_sortOrder(_prevList, begin, prevEnd, _prevOrder);
+				_sortOrder(_nextList, begin, nextEnd, _nextOrder);
+				_prevMatched.assign( prevEnd, 0 );
+				_nextMatched.assign( nextEnd, 0 );
+				
+				size_t i = 0;
+				size_t j = 0;
+				while( i < _prevOrder.size() || j < _nextOrder.size() ) {
+					if ( j == _nextOrder.size() || ( i < _prevOrder.size() && _prevList[ _prevOrder[i] ] < _nextList[ _nextOrder[j] ] ) ) {
+						outList.push_back( _prevList[ _prevOrder[i++] ].rect );
+						continue;
+					}
+					if ( i == _prevOrder.size() || _nextList[ _nextOrder[j] ] < _prevList[ _prevOrder[i] ] ) {
+						outList.push_back( _nextList[ _nextOrder[j++] ].rect );
+						continue;
+					}
+					_prevMatched[ _prevOrder[i++] ] = 1;
+					_nextMatched[ _nextOrder[j++] ] = 1;
+				}
+				
+				/// both sides hold the same shared draws, walked in painter's order they pair up unless something moved
+				i = begin;
+				j = begin;
+				while( true ) {
+					while( i < prevEnd && !_prevMatched[i] ) i++;
+					while( j < nextEnd && !_nextMatched[j] ) j++;
+					if ( i == prevEnd || j == nextEnd )
+						break;
+					
+					if ( !( _prevList[i] == _nextList[j] ) ) {
+						outList.push_back( _prevList[i].rect );
+						outList.push_back( _nextList[j].rect );
+					}
+					i++;
+					j++;
+				}
+				
+				_merge(outList, maxRects);
+			}
+	};
+
+}
@@ -5,8 +5,111 @@ namespace UIMiniEmbed {
 
 	class UIRenderDriverApi {
 		public:
+			/// srcBBox is the source rect in image pixels as min/max corners, Sprite records { sx, sy } - { sx + sw, sy + sh }.
+			/// A box without area means the whole image.
 			virtual void drawSprite(const std::string& file, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) {}
 			virtual void drawText(const std::string& text, const Vec2& pos, const float scale, const Utils::Color color) {}
+			
+			/// Interned overloads, drivers may key caches on UIString::getId() instead of hashing the text
+			virtual void drawSprite(const UIString& file, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) { drawSprite(file.getRef(), srcBBox, dstBBox, color); }
+			virtual void drawText  (const UIString& text, const Vec2& pos, const float scale, const Utils::Color color)       { drawText  (text.getRef(), pos, scale, color); }
+			
+			/// Lines of one TextBlock joined by '\n', line i at pos + ( 0, i * lineHeight ). Empty lines are included.
+			/// The default draws each line with drawText.
+			virtual void drawTextBlock(const UIString& text, const Vec2& pos, const float lineHeight, const float scale, const Utils::Color color) {
+				const auto& str = text.getRef();
+				size_t begin = 0;
+				for(size_t i = 0; ; i++) {
+					const size_t end = str.find('\n', begin);
+					drawText( str.substr( begin, end == std::string::npos ? std::string::npos : end - begin ), pos + Vec2{ 0, lineHeight * i }, scale, color );
+					if ( end == std::string::npos )
+						break;
+					begin = end + 1;
+				}
+			}
+			
+			/// Path to a handle, called once per path and driver by each sprite, not per frame.
+			/// 0 keeps the path based drawSprite. Drivers returning handles implement the handle drawSprite.
+			virtual UIResourceHandle resolveResource(const UIString& path) { return 0; }
+			virtual void drawSprite(const UIResourceHandle handle, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) {}
+			
+			/// Background loading, see UISpritePreloader. preloadResource starts loading path and returns at once,
+			/// isResourceReady is true once drawing it no longer stalls. The defaults suit drivers that load up front.
+			virtual void preloadResource(const UIString& path) {}
+			virtual bool isResourceReady(const UIString& path) { return true; }
+			
+			/// Size of text drawn by drawText at scale. false keeps the built-in monospace metrics.
+			/// Called only when the text, its scale or the driver changes.
+			virtual bool measureText(const std::string& text, const float scale, Vec2& outSize) { return false; }
+			/// Interned overload for whole labels, TextBlock measures its words through the one above
+			virtual bool measureText(const UIString& text, const float scale, Vec2& outSize) { return measureText(text.getRef(), scale, outSize); }
+			
+			/// Scissor for the draws that follow, in the same space as dstBBox. Calls nest from the outside in,
+			/// clearClipRect() is called when the outermost clip container is done.
+			virtual void setClipRect  (const BBox& clipBBox) {}
+			virtual void clearClipRect() {}
+			
+			/// Offscreen surfaces for the layer style, sharing the handle space of resolveResource.
+			/// 0 from createLayer() draws the subtree directly every frame. Between beginLayer and endLayer
+			/// draws go into the layer, cleared and sized to bbox with bbox.min at its origin, and start without
+			/// a scissor. The scissor from before beginLayer is back after endLayer. The layer is then shown by
+			/// the handle drawSprite with a source box of { 0, 0, width, height }.
+			virtual UIResourceHandle createLayer () { return 0; }
+			virtual void             releaseLayer(const UIResourceHandle handle) {}
+			virtual void             beginLayer  (const UIResourceHandle handle, const BBox& bbox) {}
+			virtual void             endLayer    () {}
+			
+			/// One texture run from UIRenderBatcher, all Sprite commands with this handle.
+			/// Instanced backends draw it as one call, the default draws each quad.
+			virtual void drawSpriteBatch(const UIResourceHandle handle, const UIRenderCommand* pCommandList, const size_t count) {
+				for(size_t i = 0; i < count; i++)
+					drawSprite( handle, pCommandList[i].srcBBox, pCommandList[i].dstBBox, pCommandList[i].color );
+			}
+			
+			void replay(const UIRenderCommandBuffer& cmdBuffer, const UIRenderCommand& cmd) {
+				switch( cmd.type ) {
+					case UIRenderCommand::Sprite    :
+						if ( cmd.handle )
+							drawSprite( cmd.handle, cmd.srcBBox, cmd.dstBBox, cmd.color );
+						else
+							drawSprite( cmdBuffer.getString(cmd.resource), cmd.srcBBox, cmd.dstBBox, cmd.color );
+						break;
+					case UIRenderCommand::Text      : drawText  ( cmdBuffer.getString(cmd.resource), cmd.dstBBox.min, cmd.scale, cmd.color ); break;
+					case UIRenderCommand::TextBlock : drawTextBlock( cmdBuffer.getString(cmd.resource), cmd.dstBBox.min, cmd.srcBBox.max.y, cmd.scale, cmd.color ); break;
+					case UIRenderCommand::Clip      : setClipRect( cmd.dstBBox ); break;
+					case UIRenderCommand::ClipReset : clearClipRect(); break;
+					case UIRenderCommand::LayerBegin: beginLayer( cmd.handle, cmd.dstBBox ); break;
+					case UIRenderCommand::LayerEnd  : endLayer(); break;
+				}
+			}
+			
+			/// One frame recorded by UIComponent::drawAll. The default replays it through the calls above,
+			/// backends that sort, batch or upload override this instead.
+			virtual void submit(const UIRenderCommandBuffer& cmdBuffer) {
+				for(const auto& cmd : cmdBuffer.getCommandListRef())
+					replay(cmdBuffer, cmd);
+			}
+			
+			/// The frame as drawAll() hands it over. The buffer is not changed again while anyone else holds
+			/// spCmdBuffer, so drivers that draw after returning keep it. The default submits right away.
+			/// drawAll() hands over the same buffer again when nothing had to be recorded, a driver holding
+			/// the previous one may compare the pointers and present what it already has.
+			virtual void submitFrame(const SP_UIRenderCommandBuffer& spCmdBuffer) {
+				submit(*spCmdBuffer);
+			}
+			
+			/// A frame regrouped by a UIRenderBatcher built from cmdBuffer. Handle runs go to drawSpriteBatch.
+			virtual void submitBatched(const UIRenderCommandBuffer& cmdBuffer, const UIRenderBatcher& batcher) {
+				const auto& commandList = batcher.getCommandListRef();
+				for(const auto& batch : batcher.getBatchListRef()) {
+					if ( batch.type == UIRenderCommand::Sprite && batch.handle ) {
+						drawSpriteBatch( batch.handle, &commandList[batch.first], batch.count );
+						continue;
+					}
+					for(uint32_t i = batch.first; i < batch.first + batch.count; i++)
+						replay(cmdBuffer, commandList[i]);
+				}
+			}
 	};
 	using SP_UIRenderDriverApi = std::shared_ptr< UIRenderDriverApi >;
 
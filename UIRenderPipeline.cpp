@@ -0,0 +1,217 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// Driver wrapper that submits frames from its own render thread, so update() and the recording
+	/// of frame N+1 run on the caller while the wrapped driver still draws frame N.
+	/// One frame is in flight at a time: submitFrame() hands the frame over and returns, and waits
+	/// only while the previous frame has not been drawn yet. drawAll() never records into a buffer
+	/// the render thread holds, so a handed over frame stays unchanged.
+	/// The wrapped driver needs no locking of its own, every call reaches it under one mutex.
+	/// resolveResource, measureText and preloading made by update() wait for a running submit.
+	/// The layer calls wait for the frame in flight, which may still draw a layer that is released.
+	///
+	///		auto spPipeline = UIRenderPipeline::create(spDriver);
+	///		SP_UIRenderDriverApi spApi = spPipeline;
+	///		root->update({ spApi });
+	///		root->drawAll(spApi);
+	///		spPipeline->finish();   // before reading the driver's output
+	class UIRenderPipeline : public UIRenderDriverApi {
+		private:
+			SP_UIRenderDriverApi _spDriver;
+			std::mutex           _driverMutex;
+			
+			/// last answer of the driver per path, isResourceReady repeats it while a submit runs
+			std::mutex                               _readyMutex;
+			std::unordered_map< std::string, bool > _readyMap;
+
+			std::mutex               _mutex;
+			std::condition_variable  _cv;
+			SP_UIRenderCommandBuffer _spFrame    = nullptr;
+			bool                     _stop       = false;
+			size_t                   _frameCount = 0;
+			size_t                   _stallCount = 0;
+
+			std::thread _thread;
+
+			void _threadMain() {
+				std::unique_lock< std::mutex > lock(_mutex);
+				while( true ) {
+					_cv.wait(lock, [this]() { return _spFrame || _stop; });
+					if ( !_spFrame )
+						return;
+
+					auto spFrame = _spFrame;
+					lock.unlock();
+					{
+						std::lock_guard< std::mutex > driverLock(_driverMutex);
+						_spDriver->submit(*spFrame);
+					}
+					spFrame = nullptr;
+					lock.lock();
+
+					_spFrame = nullptr;
+					_frameCount++;
+					_cv.notify_all();
+				}
+			}
+
+		public:
+			UIRenderPipeline(const SP_UIRenderDriverApi& spDriver) : _spDriver(spDriver) {
+				_thread = std::thread( [this]() { _threadMain(); } );
+			}
+			/// draws the frame still in flight before the thread exits
+			~UIRenderPipeline() {
+				{
+					std::lock_guard< std::mutex > lock(_mutex);
+					_stop = true;
+				}
+				_cv.notify_all();
+				_thread.join();
+			}
+
+			/// returns once the frame in flight is drawn
+			void finish() {
+				std::unique_lock< std::mutex > lock(_mutex);
+				_cv.wait(lock, [this]() { return !_spFrame; });
+			}
+
+			const SP_UIRenderDriverApi& getDriverRef () const { return _spDriver; }
+			/// frames drawn by the render thread
+			size_t getFrameCount() {
+				std::lock_guard< std::mutex > lock(_mutex);
+				return _frameCount;
+			}
+			/// submitFrame() calls that waited for the previous frame, the driver is the slower stage
+			size_t getStallCount() {
+				std::lock_guard< std::mutex > lock(_mutex);
+				return _stallCount;
+			}
+
+			virtual void submitFrame(const SP_UIRenderCommandBuffer& spCmdBuffer) override {
+				std::unique_lock< std::mutex > lock(_mutex);
+				if ( _spFrame )
+					_stallCount++;
+				_cv.wait(lock, [this]() { return !_spFrame; });
+
+				_spFrame = spCmdBuffer;
+				_cv.notify_all();
+			}
+
+			/// buffers passed by reference may change after the call, they are drawn on the caller
+			virtual void submit(const UIRenderCommandBuffer& cmdBuffer) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->submit(cmdBuffer);
+			}
+			virtual void submitBatched(const UIRenderCommandBuffer& cmdBuffer, const UIRenderBatcher& batcher) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->submitBatched(cmdBuffer, batcher);
+			}
+
+			virtual UIResourceHandle resolveResource(const UIString& path) override {
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				return _spDriver->resolveResource(path);
+			}
+			virtual void preloadResource(const UIString& path) override {
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->preloadResource(path);
+			}
+			/// polled every frame, so it repeats the driver's last answer for path instead of waiting for a running submit
+			virtual bool isResourceReady(const UIString& path) override {
+				std::unique_lock< std::mutex > driverLock(_driverMutex, std::try_to_lock);
+				std::lock_guard< std::mutex > readyLock(_readyMutex);
+				if ( !driverLock.owns_lock() ) {
+					const auto it = _readyMap.find( path.getRef() );
+					return it != _readyMap.end() && it->second;
+				}
+				
+				const bool ready = _spDriver->isResourceReady(path);
+				_readyMap[ path.getRef() ] = ready;
+				return ready;
+			}
+			virtual bool measureText(const std::string& text, const float scale, Vec2& outSize) override {
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				return _spDriver->measureText(text, scale, outSize);
+			}
+			virtual bool measureText(const UIString& text, const float scale, Vec2& outSize) override {
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				return _spDriver->measureText(text, scale, outSize);
+			}
+			/// a new layer may get the handle of one the frame in flight still draws
+			virtual UIResourceHandle createLayer() override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				return _spDriver->createLayer();
+			}
+			virtual void releaseLayer(const UIResourceHandle handle) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->releaseLayer(handle);
+			}
+
+			/// direct draws land after the frame in flight
+			virtual void drawSprite(const std::string& file, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->drawSprite(file, srcBBox, dstBBox, color);
+			}
+			virtual void drawText(const std::string& text, const Vec2& pos, const float scale, const Utils::Color color) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->drawText(text, pos, scale, color);
+			}
+			virtual void drawSprite(const UIString& file, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->drawSprite(file, srcBBox, dstBBox, color);
+			}
+			virtual void drawText(const UIString& text, const Vec2& pos, const float scale, const Utils::Color color) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->drawText(text, pos, scale, color);
+			}
+			virtual void drawTextBlock(const UIString& text, const Vec2& pos, const float lineHeight, const float scale, const Utils::Color color) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->drawTextBlock(text, pos, lineHeight, scale, color);
+			}
+			virtual void drawSprite(const UIResourceHandle handle, const BBox& srcBBox, const BBox& dstBBox, const Utils::Color color) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->drawSprite(handle, srcBBox, dstBBox, color);
+			}
+			virtual void drawSpriteBatch(const UIResourceHandle handle, const UIRenderCommand* pCommandList, const size_t count) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->drawSpriteBatch(handle, pCommandList, count);
+			}
+			virtual void setClipRect(const BBox& clipBBox) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->setClipRect(clipBBox);
+			}
+			virtual void clearClipRect() override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->clearClipRect();
+			}
+			virtual void beginLayer(const UIResourceHandle handle, const BBox& bbox) override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->beginLayer(handle, bbox);
+			}
+			virtual void endLayer() override {
+				finish();
+				std::lock_guard< std::mutex > driverLock(_driverMutex);
+				_spDriver->endLayer();
+			}
+
+			static std::shared_ptr< UIRenderPipeline > create(const SP_UIRenderDriverApi& spDriver) {
+				return std::make_shared< UIRenderPipeline >(spDriver);
+			}
+	};
+	using SP_UIRenderPipeline = std::shared_ptr< UIRenderPipeline >;
+
+}
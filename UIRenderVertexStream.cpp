@@ -0,0 +1,162 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// GPU layout quad corner: position, texel uv, premultiplied RGBA8 with r in the low byte
+	struct UIVertex {
+		float    x;
+		float    y;
+		float    u;
+		float    v;
+		uint32_t color;
+	};
+	static_assert( sizeof(UIVertex) == 20 );
+
+	/// A range of the vertex stream drawn with one texture, or a command that is not a quad.
+	/// Text and clip runs carry no vertices, the host draws them through command.
+	struct UIVertexRun {
+		UIRenderCommand::EnumType type        = UIRenderCommand::Sprite;
+		UIResourceHandle          handle      = 0;
+		/// string index of the path when handle is 0, or of the text
+		uint32_t                  resource    = 0;
+		uint32_t                  firstVertex = 0;
+		uint32_t                  vertexCount = 0;
+		/// first command of the run in the list that was written
+		uint32_t                  command     = 0;
+	};
+
+	/// Writes the sprites of a command list as quads, 4 vertices each, into a buffer owned by the caller.
+	/// Positions are dstBBox * scale + offset, uvs srcBBox * uvScale, or 0..1 when srcBBox has no area and so
+	/// means the whole image. uvScale is looked up per run when a uv scale function is set, textures of
+	/// different sizes share one stream that way.
+	/// Quad corners go top left, top right, bottom left, bottom right, see writeQuadIndexList.
+	///
+	///		auto* pVertexList = (UIVertex*)mapVertexBuffer( UIRenderVertexStream::getVertexCount(cmdBuffer.getCommandListRef()) );
+	///		stream.write( cmdBuffer, pVertexList, capacity );
+	///		for(const auto& run : stream.getRunListRef()) ...
+	class UIRenderVertexStream {
+		private:
+			Vec2 _scale   = { 1, 1 };
+			Vec2 _offset;
+			Vec2 _uvScale = { 1, 1 };
+			std::function< Vec2(const UIVertexRun& run) > _fUVScale;
+
+			std::vector< UIVertexRun > _runList;
+			size_t                     _vertexCount = 0;
+
+			static uint32_t _premultiply(const Utils::Color color) {
+				const float alpha = (float)color.a * ( 1.0f / 255.0f );
+				float rgba[4];
+				( UIFloat4::set( color.r, color.g, color.b, color.a ) * UIFloat4::set( alpha, alpha, alpha, 1 ) + UIFloat4::splat(0.5f) ).store(rgba);
+				return (uint32_t)rgba[0] | ( (uint32_t)rgba[1] << 8 ) | ( (uint32_t)rgba[2] << 16 ) | ( (uint32_t)rgba[3] << 24 );
+			}
+
+		public:
+			/// e.g. scale { 2 / w, -2 / h } and offset { -1, 1 } for clip space, uvScale { 1 / atlasW, 1 / atlasH }
+			void setTransform(const Vec2& scale, const Vec2& offset, const Vec2& uvScale = { 1, 1 }) {
+				_scale   = scale;
+				_offset  = offset;
+				_uvScale = uvScale;
+			}
+			/// Called once per sprite run with its handle or path string index, returns { 1 / textureW, 1 / textureH }.
+			/// Replaces the uvScale of setTransform, nullptr goes back to it.
+			void setUVScaleFunc(std::function< Vec2(const UIVertexRun& run) > fUVScale) {
+				_fUVScale = std::move(fUVScale);
+			}
+
+			static size_t getVertexCount(const std::vector< UIRenderCommand >& commandList) {
+				size_t count = 0;
+				for(const auto& cmd : commandList)
+					if ( cmd.type == UIRenderCommand::Sprite )
+						count += 4;
+				return count;
+			}
+
+			/// false without writing anything when pVertexList holds fewer than getVertexCount(commandList)
+			bool write(const std::vector< UIRenderCommand >& commandList, UIVertex* pVertexList, const size_t vertexCapacity) {
+				_runList.clear();
+				_vertexCount = 0;
+				if ( getVertexCount(commandList) > vertexCapacity )
+					return false;
+
+				const auto posScale  = UIFloat4::set( _scale.x  , _scale.y  , _scale.x  , _scale.y   );
+				const auto posOffset = UIFloat4::set( _offset.x , _offset.y , _offset.x , _offset.y  );
+				auto       uvScale   = UIFloat4::set( _uvScale.x, _uvScale.y, _uvScale.x, _uvScale.y );
+				const auto uvWhole   = UIFloat4::set( 0, 0, 1, 1 );
+
+				UIVertex* pVertex = pVertexList;
+				for(uint32_t i = 0; i < commandList.size(); i++) {
+					const auto& cmd = commandList[i];
+					if ( cmd.type != UIRenderCommand::Sprite ) {
+						UIVertexRun run;
+						run.type        = cmd.type;
+						run.resource    = cmd.resource;
+						run.firstVertex = (uint32_t)_vertexCount;
+						run.command     = i;
+						_runList.push_back(run);
+						continue;
+					}
+
+					const uint32_t resource = cmd.handle ? 0 : cmd.resource;
+					if ( _runList.empty() || _runList.back().type != UIRenderCommand::Sprite ||
+						_runList.back().handle != cmd.handle || _runList.back().resource != resource ) {
+						UIVertexRun run;
+						run.handle      = cmd.handle;
+						run.resource    = resource;
+						run.firstVertex = (uint32_t)_vertexCount;
+						run.command     = i;
+						_runList.push_back(run);
+
+						if ( _fUVScale ) {
+							const auto runUVScale = _fUVScale(run);
+							uvScale = UIFloat4::set( runUVScale.x, runUVScale.y, runUVScale.x, runUVScale.y );
+						}
+					}
+
+					float pos[4];
+					float uv [4];
+					( UIFloat4::load(cmd.dstBBox) * posScale + posOffset ).store(pos);
+					if ( cmd.srcBBox.getWidth() > 0 && cmd.srcBBox.getHeight() > 0 )
+						( UIFloat4::load(cmd.srcBBox) * uvScale ).store(uv);
+					else
+						uvWhole.store(uv);
+					const uint32_t color = _premultiply(cmd.color);
+
+					pVertex[0] = UIVertex{ pos[0], pos[1], uv[0], uv[1], color };
+					pVertex[1] = UIVertex{ pos[2], pos[1], uv[2], uv[1], color };
+					pVertex[2] = UIVertex{ pos[0], pos[3], uv[0], uv[3], color };
+					pVertex[3] = UIVertex{ pos[2], pos[3], uv[2], uv[3], color };
+					pVertex += 4;
+
+					_vertexCount += 4;
+					_runList.back().vertexCount += 4;
+				}
+				return true;
+			}
+			bool write(const UIRenderCommandBuffer& cmdBuffer, UIVertex* pVertexList, const size_t vertexCapacity) {
+				return write( cmdBuffer.getCommandListRef(), pVertexList, vertexCapacity );
+			}
+			/// batched order gives one run per texture run of the batcher
+			bool write(const UIRenderBatcher& batcher, UIVertex* pVertexList, const size_t vertexCapacity) {
+				return write( batcher.getCommandListRef(), pVertexList, vertexCapacity );
+			}
+
+			size_t                            getVertexCount() const { return _vertexCount; }
+			const std::vector< UIVertexRun >& getRunListRef () const { return _runList;     }
+
+			/// two triangles per quad, the same for every frame, so it can live in a static index buffer
+			static void writeQuadIndexList(uint32_t* pIndexList, const size_t quadCount) {
+				for(uint32_t q = 0; q < quadCount; q++) {
+					const uint32_t base = q * 4;
+					pIndexList[0] = base + 0;
+					pIndexList[1] = base + 1;
+					pIndexList[2] = base + 2;
+					pIndexList[3] = base + 2;
+					pIndexList[4] = base + 1;
+					pIndexList[5] = base + 3;
+					pIndexList += 6;
+				}
+			}
+	};
+
+}
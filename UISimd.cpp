@@ -0,0 +1,68 @@
+#pragma once
+
+#if !defined(UIMINIEMBED_NO_SIMD) && ( defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 ) )
+	#define UIMINIEMBED_SIMD_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define UIMINIEMBED_SIMD_SSE2 0
+#endif
+
+namespace UIMiniEmbed {
+
+	/// Four packed floats. Lane order matches BBox { min.x, min.y, max.x, max.y }.
+	/// Only exact IEEE ops (add, sub, mul, select), so SIMD and scalar builds give identical results.
+	struct UIFloat4 {
+#if UIMINIEMBED_SIMD_SSE2
+		__m128 v;
+
+		static UIFloat4 load (const float* p)                                         { return { _mm_loadu_ps(p) }; }
+		static UIFloat4 set  (const float a, const float b, const float c, const float d) { return { _mm_setr_ps(a, b, c, d) }; }
+		static UIFloat4 splat(const float a)                                          { return { _mm_set1_ps(a) }; }
+		static UIFloat4 mask (const bool a, const bool b, const bool c, const bool d) {
+			return { _mm_castsi128_ps( _mm_setr_epi32( a ? -1 : 0, b ? -1 : 0, c ? -1 : 0, d ? -1 : 0 ) ) };
+		}
+		void store(float* p) const { _mm_storeu_ps(p, v); }
+
+		friend UIFloat4 operator+(const UIFloat4& a, const UIFloat4& b) { return { _mm_add_ps(a.v, b.v) }; }
+		friend UIFloat4 operator-(const UIFloat4& a, const UIFloat4& b) { return { _mm_sub_ps(a.v, b.v) }; }
+		friend UIFloat4 operator*(const UIFloat4& a, const UIFloat4& b) { return { _mm_mul_ps(a.v, b.v) }; }
+
+		/// lanes of mask set pick a, others pick b
+		static UIFloat4 select(const UIFloat4& mask, const UIFloat4& a, const UIFloat4& b) {
+			return { _mm_or_ps( _mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v) ) };
+		}
+#else
+		float v[4];
+
+		static UIFloat4 load (const float* p)                                         { return { { p[0], p[1], p[2], p[3] } }; }
+		static UIFloat4 set  (const float a, const float b, const float c, const float d) { return { { a, b, c, d } }; }
+		static UIFloat4 splat(const float a)                                          { return { { a, a, a, a } }; }
+		static UIFloat4 mask (const bool a, const bool b, const bool c, const bool d) {
+			return { { a ? 1.0f : 0.0f, b ? 1.0f : 0.0f, c ? 1.0f : 0.0f, d ? 1.0f : 0.0f } };
+		}
+		void store(float* p) const { for(int i = 0; i < 4; i++) p[i] = v[i]; }
+
+		friend UIFloat4 operator+(const UIFloat4& a, const UIFloat4& b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+		friend UIFloat4 operator-(const UIFloat4& a, const UIFloat4& b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+		friend UIFloat4 operator*(const UIFloat4& a, const UIFloat4& b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+
+		static UIFloat4 select(const UIFloat4& mask, const UIFloat4& a, const UIFloat4& b) {
+			UIFloat4 r;
+			for(int i = 0; i < 4; i++)
+				r.v[i] = ( mask.v[i] != 0 ) ? a.v[i] : b.v[i];
+			return r;
+		}
+#endif
+
+		static UIFloat4 load (const BBox& bbox) { return load( &bbox.min.x ); }
+		void            store(BBox& bbox) const { store( &bbox.min.x ); }
+	};
+	static_assert( sizeof(BBox) == sizeof(float) * 4 );
+
+	inline void uiPrefetch(const void* p) {
+#if UIMINIEMBED_SIMD_SSE2
+		_mm_prefetch( (const char*)p, _MM_HINT_T0 );
+#endif
+	}
+
+}
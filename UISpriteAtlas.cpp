@@ -0,0 +1,250 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// Constant path props of Sprite and SpriteFrameAnimation nodes reachable from spNodeDesc, alias bodies
+	/// and both sides of if included. Appended in walk order, paths already in outPathList are skipped.
+	void collectSpritePaths(const SP_UINodeDesc& spNodeDesc, std::vector< std::string >& outPathList) {
+		if ( !spNodeDesc )
+			return;
+
+		std::unordered_set< std::string > pathSet( outPathList.begin(), outPathList.end() );
+		spNodeDesc->walk( [&](const UINodeDesc& nodeDesc) {
+			const auto componentName = nodeDesc.getComponentName();
+			if ( componentName != "Sprite" && componentName != "SpriteFrameAnimation" )
+				return;
+
+			for(const auto& prop : nodeDesc.getProps()) {
+				if ( prop.getName() != "path" || prop.getType() != UINodePropDesc::ConstString || prop.getValue().empty() )
+					continue;
+				if ( pathSet.insert( prop.getValue() ).second )
+					outPathList.push_back( prop.getValue() );
+			}
+		} );
+	}
+
+	/// Where one image ended up inside an atlas
+	struct UISpriteAtlasEntry {
+		UIString atlas;
+		/// top left of the image in the atlas
+		Vec2     offset;
+		/// image size, stands in for the empty source box that means the whole image
+		Vec2     size;
+
+		BBox remap(const BBox& srcBBox) const {
+			if ( !( srcBBox.getWidth() > 0 && srcBBox.getHeight() > 0 ) )
+				return BBox{ offset, offset + size };
+			return BBox{ srcBBox.min + offset, srcBBox.max + offset };
+		}
+	};
+
+	/// Image path -> atlas region, handed to update() in UIUpdateContext::spAtlasMap.
+	/// Sprites whose path is in the map draw from the atlas with their source box moved into it.
+	class UISpriteAtlasMap {
+		private:
+			std::unordered_map< std::string, UISpriteAtlasEntry > _map;
+
+		public:
+			void add(const std::string& path, const UISpriteAtlasEntry& entry) {
+				_map[path] = entry;
+			}
+			const UISpriteAtlasEntry* find(const UIString& path) const {
+				const auto it = _map.find( path.getRef() );
+				return ( it != _map.end() ) ? &it->second : nullptr;
+			}
+			size_t getSize() const { return _map.size(); }
+
+			/// one line per image, sorted by path: path, atlas, x, y, width, height separated by tabs
+			std::string dump() const {
+				std::vector< const std::pair< const std::string, UISpriteAtlasEntry >* > itemList;
+				for(const auto& item : _map)
+					itemList.push_back(&item);
+				std::sort( itemList.begin(), itemList.end(), [](const auto* a, const auto* b) { return a->first < b->first; } );
+
+				std::string out;
+				for(const auto* pItem : itemList) {
+					const auto& entry = pItem->second;
+					out += pItem->first + "\t" + entry.atlas.getRef() + "\t" +
+						std::to_string( (int32_t)entry.offset.x ) + "\t" + std::to_string( (int32_t)entry.offset.y ) + "\t" +
+						std::to_string( (int32_t)entry.size.x   ) + "\t" + std::to_string( (int32_t)entry.size.y   ) + "\n";
+				}
+				return out;
+			}
+			/// reads what dump() wrote, false on a malformed line
+			bool parse(const std::string& text) {
+				std::istringstream lineStream(text);
+				std::string line;
+				while( std::getline(lineStream, line) ) {
+					if ( line.empty() )
+						continue;
+
+					std::vector< std::string > fieldList;
+					size_t first = 0;
+					for(size_t i = 0; i <= line.size(); i++) {
+						if ( i == line.size() || line[i] == '\t' ) {
+							fieldList.push_back( line.substr(first, i - first) );
+							first = i + 1;
+						}
+					}
+					if ( fieldList.size() != 6 || fieldList[0].empty() || fieldList[1].empty() )
+						return false;
+
+					UISpriteAtlasEntry entry;
+					entry.atlas  = UIString( fieldList[1] );
+					entry.offset = Vec2{ stringToFloat( fieldList[2] ), stringToFloat( fieldList[3] ) };
+					entry.size   = Vec2{ stringToFloat( fieldList[4] ), stringToFloat( fieldList[5] ) };
+					add( fieldList[0], entry );
+				}
+				return true;
+			}
+
+			static std::shared_ptr< UISpriteAtlasMap > create() {
+				return std::make_shared< UISpriteAtlasMap >();
+			}
+	};
+	using SP_UISpriteAtlasMap = std::shared_ptr< UISpriteAtlasMap >;
+
+	/// Offline atlas builder. Collects the constant sprite paths of parsed markup, takes their pixels
+	/// from the host and packs them into atlases on shelves, tallest first. Every image gets padding
+	/// filled with its own edge pixels, so bilinear sampling never bleeds in a neighbour.
+	/// Images larger than an atlas stay out of the map and keep drawing from their own path.
+	///
+	///		UISpriteAtlasPacker packer;
+	///		packer.collect( parseResult.result );
+	///		for(const auto& path : packer.getPathListRef()) packer.addImage( path, w, h, pRGBA );
+	///		packer.pack("atlas");
+	///		for(const auto& atlas : packer.getAtlasListRef()) savePNG( atlas.path, atlas.width, atlas.height, atlas.pixelList );
+	///		save( "atlas.map", packer.getMapRef().dump() );
+	class UISpriteAtlasPacker {
+		public:
+			/// RGBA8, 4 bytes per pixel in r, g, b, a order
+			struct TAtlas {
+				std::string            path;
+				int32_t                width  = 0;
+				int32_t                height = 0;
+				std::vector< uint8_t > pixelList;
+			};
+
+		private:
+			struct TImage {
+				std::string            path;
+				int32_t                width  = 0;
+				int32_t                height = 0;
+				std::vector< uint8_t > pixelList;
+				int32_t                atlas  = -1;
+				int32_t                x      = 0;
+				int32_t                y      = 0;
+			};
+
+			std::vector< std::string > _pathList;
+			std::vector< TImage >      _imageList;
+			std::vector< TAtlas >      _atlasList;
+			UISpriteAtlasMap           _map;
+
+			static int32_t _clampIndex(const int32_t value, const int32_t size) {
+				return value < 0 ? 0 : ( value >= size ? size - 1 : value );
+			}
+
+			void _copyImage(const TImage& image, TAtlas& atlas, const int32_t padding) {
+				for(int32_t y = -padding; y < image.height + padding; y++) {
+					const int32_t sy = _clampIndex(y, image.height);
+					for(int32_t x = -padding; x < image.width + padding; x++) {
+						const int32_t sx = _clampIndex(x, image.width);
+						const uint8_t* pSrc = &image.pixelList[ ( (size_t)sy * image.width + sx ) * 4 ];
+						uint8_t*       pDst = &atlas.pixelList[ ( (size_t)( image.y + y ) * atlas.width + image.x + x ) * 4 ];
+						std::memcpy( pDst, pSrc, 4 );
+					}
+				}
+			}
+
+		public:
+			/// see collectSpritePaths, may be called for several trees
+			void collect(const SP_UINodeDesc& spNodeDesc) {
+				collectSpritePaths(spNodeDesc, _pathList);
+			}
+			const std::vector< std::string >& getPathListRef() const { return _pathList; }
+
+			/// pRGBA is width * height pixels, copied. Paths that were not collected may be added too.
+			bool addImage(const std::string& path, const int32_t width, const int32_t height, const uint8_t* pRGBA) {
+				if ( width <= 0 || height <= 0 || !pRGBA )
+					return false;
+
+				TImage image;
+				image.path   = path;
+				image.width  = width;
+				image.height = height;
+				image.pixelList.assign( pRGBA, pRGBA + (size_t)width * height * 4 );
+				_imageList.push_back( std::move(image) );
+				return true;
+			}
+
+			/// Packs every added image into atlases of at most maxSize pixels a side, named
+			/// atlasPrefix + index + ".png". Returns the number of images placed.
+			size_t pack(const std::string& atlasPrefix, const int32_t maxSize = 2048, const int32_t padding = 1) {
+				_atlasList.clear();
+				_map = UISpriteAtlasMap{};
+
+				std::vector< TImage* > orderList;
+				for(auto& image : _imageList) {
+					image.atlas = -1;
+					if ( image.width + padding * 2 <= maxSize && image.height + padding * 2 <= maxSize )
+						orderList.push_back(&image);
+				}
+				std::sort( orderList.begin(), orderList.end(), [](const TImage* a, const TImage* b) {
+					if ( a->height != b->height ) return a->height > b->height;
+					if ( a->width  != b->width  ) return a->width  > b->width;
+					return a->path < b->path;
+				} );
+
+				int32_t shelfX = 0;
+				int32_t shelfY = 0;
+				int32_t shelfHeight = 0;
+				for(auto* pImage : orderList) {
+					const int32_t cellWidth  = pImage->width  + padding * 2;
+					const int32_t cellHeight = pImage->height + padding * 2;
+
+					if ( _atlasList.size() && shelfX + cellWidth > maxSize ) {
+						shelfX      = 0;
+						shelfY     += shelfHeight;
+						shelfHeight = 0;
+					}
+					if ( _atlasList.empty() || shelfY + cellHeight > maxSize ) {
+						_atlasList.emplace_back();
+						_atlasList.back().path = atlasPrefix + std::to_string( _atlasList.size() - 1 ) + ".png";
+						shelfX      = 0;
+						shelfY      = 0;
+						shelfHeight = 0;
+					}
+
+					auto& atlas = _atlasList.back();
+					pImage->atlas = (int32_t)_atlasList.size() - 1;
+					pImage->x     = shelfX + padding;
+					pImage->y     = shelfY + padding;
+
+					shelfX      += cellWidth;
+					shelfHeight  = shelfHeight > cellHeight ? shelfHeight : cellHeight;
+					atlas.width  = atlas.width  > shelfX                ? atlas.width  : shelfX;
+					atlas.height = atlas.height > shelfY + shelfHeight ? atlas.height : shelfY + shelfHeight;
+				}
+
+				for(auto& atlas : _atlasList)
+					atlas.pixelList.assign( (size_t)atlas.width * atlas.height * 4, 0 );
+
+				for(const auto* pImage : orderList) {
+					auto& atlas = _atlasList[ pImage->atlas ];
+					_copyImage(*pImage, atlas, padding);
+
+					UISpriteAtlasEntry entry;
+					entry.atlas  = UIString( atlas.path );
+					entry.offset = Vec2{ (float)pImage->x    , (float)pImage->y      };
+					entry.size   = Vec2{ (float)pImage->width, (float)pImage->height };
+					_map.add( pImage->path, entry );
+				}
+				return orderList.size();
+			}
+
+			const std::vector< TAtlas >& getAtlasListRef() const { return _atlasList; }
+			const UISpriteAtlasMap&      getMapRef      () const { return _map;       }
+	};
+
+}
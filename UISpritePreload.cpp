@@ -0,0 +1,123 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// Warms sprite images before the markup showing them is created, so its first frame does not stall.
+	/// preload() hands every path collectSpritePaths finds to the driver's preloadResource and returns a var
+	/// that turns true once all of them are ready. Each path has a ready var of its own as well.
+	/// update() polls the driver for the paths still loading, main thread only like every var.
+	/// Paths in the atlas map load their atlas instead.
+	///
+	///		UISpritePreloader preloader(spApi);
+	///		spVarEnv->setVar( "shopReady", preloader.preload(spShopDesc) );   // markup: if flag=$shopReady
+	///		...each frame: preloader.update(); root->update({ spApi });
+	class UISpritePreloader {
+		private:
+			struct TPath {
+				/// what the driver loads, the atlas of a packed path
+				UIString resource;
+				UIVar    ready;
+				bool     isReady = false;
+			};
+			struct TGroup {
+				std::vector< size_t > pathIndexList;
+				UIVar                 ready;
+				bool                  isReady = false;
+			};
+
+			SP_UIRenderDriverApi _spApi;
+			SP_UISpriteAtlasMap  _spAtlasMap;
+
+			std::vector< TPath >                      _pathList;
+			std::unordered_map< std::string, size_t > _pathIndexMap;
+			std::vector< TGroup >                     _groupList;
+			size_t                                    _pendingCount = 0;
+
+			size_t _addPath(const std::string& path) {
+				const auto it = _pathIndexMap.find(path);
+				if ( it != _pathIndexMap.end() )
+					return it->second;
+
+				TPath rec;
+				rec.resource = UIString(path);
+				if ( _spAtlasMap ) {
+					const auto* pAtlas = _spAtlasMap->find(rec.resource);
+					if ( pAtlas )
+						rec.resource = pAtlas->atlas;
+				}
+
+				_spApi->preloadResource(rec.resource);
+				rec.isReady = _spApi->isResourceReady(rec.resource);
+				rec.ready.setBool(rec.isReady);
+				if ( !rec.isReady )
+					_pendingCount++;
+
+				_pathList.push_back(rec);
+				_pathIndexMap.emplace( path, _pathList.size() - 1 );
+				return _pathList.size() - 1;
+			}
+
+			bool _updateGroup(TGroup& group) {
+				for(const auto index : group.pathIndexList)
+					if ( !_pathList[index].isReady )
+						return false;
+
+				group.isReady = true;
+				group.ready.setBool(true);
+				return true;
+			}
+
+		public:
+			UISpritePreloader(SP_UIRenderDriverApi spApi, SP_UISpriteAtlasMap spAtlasMap = nullptr) : _spApi(spApi), _spAtlasMap(spAtlasMap) {}
+
+			/// starts loading the sprite paths of spNodeDesc, the var is true once all of them are ready
+			UIVar preload(const SP_UINodeDesc& spNodeDesc) {
+				std::vector< std::string > pathList;
+				collectSpritePaths(spNodeDesc, pathList);
+
+				TGroup group;
+				for(const auto& path : pathList)
+					group.pathIndexList.push_back( _addPath(path) );
+				group.ready.setBool(false);
+				_updateGroup(group);
+
+				_groupList.push_back(group);
+				return group.ready;
+			}
+			/// a single path, the var is the one getReadyVar returns
+			UIVar preloadPath(const std::string& path) {
+				return _pathList[ _addPath(path) ].ready;
+			}
+			/// null var for paths never preloaded
+			UIVar getReadyVar(const std::string& path) const {
+				const auto it = _pathIndexMap.find(path);
+				return ( it != _pathIndexMap.end() ) ? _pathList[ it->second ].ready : UIVar{};
+			}
+
+			/// true when any var turned true
+			bool update() {
+				if ( !_pendingCount )
+					return false;
+
+				bool changed = false;
+				for(auto& rec : _pathList) {
+					if ( rec.isReady || !_spApi->isResourceReady(rec.resource) )
+						continue;
+
+					rec.isReady = true;
+					rec.ready.setBool(true);
+					_pendingCount--;
+					changed = true;
+				}
+
+				if ( changed )
+					for(auto& group : _groupList)
+						if ( !group.isReady )
+							_updateGroup(group);
+				return changed;
+			}
+
+			size_t getPendingCount() const { return _pendingCount; }
+	};
+
+}
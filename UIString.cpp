@@ -0,0 +1,84 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// Immutable interned string. Equal contents share one refcounted buffer, so
+	/// equality is a pointer comparison and copies never touch the characters.
+	class UIStringPool {
+		private:
+			using TMap = std::unordered_map< std::string_view, std::weak_ptr< const std::string > >;
+
+			std::mutex _mutex;
+			TMap       _map;
+
+			void _release(const std::string* pData) {
+				{
+					std::lock_guard< std::mutex > lock(_mutex);
+
+					auto it = _map.find( std::string_view(*pData) );
+					if ( it != _map.end() && it->first.data() == pData->data() && it->second.expired() )
+						_map.erase(it);
+				}
+
+				delete pData;
+			}
+
+		public:
+			std::shared_ptr< const std::string > intern(const std::string_view& val) {
+				std::lock_guard< std::mutex > lock(_mutex);
+
+				auto it = _map.find(val);
+				if ( it != _map.end() ) {
+					auto spData = it->second.lock();
+					if ( spData )
+						return spData;
+
+					_map.erase(it);
+				}
+
+				auto spData = std::shared_ptr< const std::string >( new std::string(val), [this](const std::string* pData) { _release(pData); } );
+				_map.emplace( std::string_view(*spData), spData );
+				return spData;
+			}
+
+			size_t getSize() {
+				std::lock_guard< std::mutex > lock(_mutex);
+				return _map.size();
+			}
+
+			/// never destroyed, handles may outlive static destruction order
+			static UIStringPool& get() {
+				static UIStringPool* pPool = new UIStringPool();
+				return *pPool;
+			}
+	};
+
+	class UIString {
+		private:
+			std::shared_ptr< const std::string > _spData = nullptr;
+
+			static const std::string& _getEmpty() {
+				static const std::string empty = "";
+				return empty;
+			}
+
+		public:
+			UIString() {}
+			UIString(const std::string& val) {
+				if ( val.length() )
+					_spData = UIStringPool::get().intern(val);
+			}
+
+			const std::string& getRef   () const { return _spData ? *_spData : _getEmpty(); }
+			std::string        get      () const { return getRef(); }
+			size_t             length   () const { return getRef().length(); }
+			bool               isEmpty  () const { return !_spData; }
+
+			/// stable while any handle to the same contents is alive
+			const void*        getId    () const { return _spData.get(); }
+
+			bool operator ==(const UIString& other) const { return _spData == other._spData; }
+			bool operator !=(const UIString& other) const { return _spData != other._spData; }
+	};
+
+}
@@ -42,6 +42,9 @@ namespace UIMiniEmbed {
 				return 0;
 			}
 			
+			EnumType getType () const { return _type; }
+			float    getValue() const { return _value; }
+			
 			bool  isNone     () const { return _type == None; }
 			bool  isFraction () const { return _type == Fraction; }
 			float getFraction() const {
@@ -71,4 +74,19 @@ namespace UIMiniEmbed {
 		End,
 	};
 
+	/// Everything the layout reads from one node, resolved through the virtual getters only when its vars change
+	struct UIResolvedStyle {
+		UIPosValVariant     width;
+		UIPosValVariant     height;
+		UIPosValVariantRect padding;
+		UIPosValVariantRect position;
+		UIPosValVariant     gap;
+		
+		bool                relative  = false;
+		bool                absolute  = false;
+		UIEnumDirection     direction = UIEnumDirection::Row;
+		UIEnumAlign         alignX    = UIEnumAlign::Start;
+		UIEnumAlign         alignY    = UIEnumAlign::Start;
+	};
+
 }
@@ -2,6 +2,10 @@
 
 namespace UIMiniEmbed {
 	
+	/// One counter for every var, so the newest change among a set of vars is simply the max of their sequences
+	uint64_t g_UIVarSequence = 1;
+	uint64_t var_NextSequence() { return ++g_UIVarSequence; }
+	
 	struct _UIVarType {
 		enum EnumVarType {
 			Null,
@@ -42,11 +46,12 @@ namespace UIMiniEmbed {
 			int32_t     _i32    = 0;
 			float       _float  = 0;
 			std::string _string = "";
+			UIString    _ustring;
 			
 			TListVar    _list;
 			TMapVar     _map;
 			
-			uint32_t    _invalidateSequence = 1;
+			uint64_t    _invalidateSequence = 1;
 			
 			template< EnumVarType eNewType >
 			bool _checkAndUpdateType() {
@@ -54,8 +59,9 @@ namespace UIMiniEmbed {
 					return true;
 				
 				switch( getType() ) {
-					case List: _list.clear(); break;
-					case Map : _map .clear(); break;
+					case String: _ustring = {};    break;
+					case List  : _list.clear(); break;
+					case Map   : _map .clear(); break;
 				}
 				
 				_type = eNewType;
@@ -81,7 +87,19 @@ namespace UIMiniEmbed {
 			}
 		
 			void _invalidate() {
-				_invalidateSequence++;
+				_invalidateSequence = var_NextSequence();
+			}
+
+			/// String values live in the interned handle, every other type keeps its text form in _string
+			const std::string& _getStringRef() const {
+				if ( getType() == String )
+					return _ustring.getRef();
+				return _string;
+			}
+			UIString           _getUIString () const {
+				if ( getType() == String )
+					return _ustring;
+				return UIString(_string);
 			}
 
 
@@ -93,7 +111,7 @@ namespace UIMiniEmbed {
 					case Null   : return true;
 					case Boolean: return _bool   == other._bool;
 					case I32    : return _i32    == other._i32;
-					case String : return _string == other._string;
+					case String : return _ustring == other._ustring;
 				
 					case Float:
 					case StylePixel:
@@ -156,7 +174,7 @@ namespace UIMiniEmbed {
 					case Null   : return gap + "null";
 					case Boolean: return gap + _string;
 					case I32    : return gap + _string + "i";
-					case String : return gap + "\"" + _string + "\"";
+					case String : return gap + "\"" + _ustring.getRef() + "\"";
 				
 					case Float: return gap + _string + "f";
 					case StylePixel: return gap + _string + "px";
@@ -184,8 +202,8 @@ namespace UIMiniEmbed {
 				return "{Invalid}";
 			}
 
-			static SP_UIVarInternal create() {
-				return std::make_shared< UIVarInternal >();
+			static SP_UIVarInternal create(UIArena* pArena = nullptr) {
+				return arenaMakeShared< UIVarInternal >(pArena);
 			}
 	
 	};
@@ -195,7 +213,10 @@ namespace UIMiniEmbed {
 	class UIVar : public _UIVarType {
 		private:
 			SP_UIVarInternal _spVarInternal      = UIVarInternal::create();
-			uint32_t         _invalidateSequence = 0;
+			uint64_t         _invalidateSequence = 0;
+
+			struct TInternalTag {};
+			UIVar(TInternalTag, SP_UIVarInternal spVar) : _spVarInternal(spVar) {}
 
 			bool _setVarInternal(SP_UIVarInternal spVar) {
 				if ( !spVar ) 
@@ -223,14 +244,17 @@ namespace UIMiniEmbed {
 			bool               getBool     () const { return _spVarInternal->_bool;     }
 			int32_t            getI32      () const { return _spVarInternal->_i32;      }
 			float              getFloat    () const { return _spVarInternal->_float;    }
-			std::string        getString   () const { return _spVarInternal->_string;   }
-			const std::string& getStringRef() const { return _spVarInternal->_string;   }
+			std::string        getString   () const { return _spVarInternal->_getStringRef(); }
+			const std::string& getStringRef() const { return _spVarInternal->_getStringRef(); }
+			UIString           getUIString () const { return _spVarInternal->_getUIString (); }
 			
 			float              getPixel    () const { return getFloat();                }
 			float              getPercent  () const { return getFloat();                }
 			float              getFraction () const { return max(1, getFloat());        }
 			
 			std::string dump() const { return _spVarInternal->dump(); }
+			
+			uint64_t    getInvalidateSequence() const { return _spVarInternal->_invalidateSequence; }
 		
 			bool setNull() {
 				if ( _spVarInternal->_checkAndUpdateType< Null >() )
@@ -272,19 +296,21 @@ namespace UIMiniEmbed {
 				return true;
 			}
 
-			bool setString(const std::string& val) {
+			bool setString(const UIString& val) {
 				if ( _spVarInternal->_checkAndUpdateType< String >() )
-					if ( _spVarInternal->_string == val )
+					if ( _spVarInternal->_ustring == val )
 						return false;
 				
-				_spVarInternal->_bool   = val.length() ? true : false;
-				_spVarInternal->_i32    = 0;
-				_spVarInternal->_float  = 0;
-				_spVarInternal->_string = val;
+				_spVarInternal->_bool    = val.length() ? true : false;
+				_spVarInternal->_i32     = 0;
+				_spVarInternal->_float   = 0;
+				_spVarInternal->_string  = "";
+				_spVarInternal->_ustring = val;
 				
 				_spVarInternal->_invalidate();
 				return true;
 			}
+			bool setString(const std::string& val) { return setString( UIString(val) ); }
 
 			bool setFloat   (const float val) { return _spVarInternal->_setFloatEx< Float         >(val); }
 			bool setPixel   (const float val) { return _spVarInternal->_setFloatEx< StylePixel    >(val); }
@@ -359,6 +385,7 @@ namespace UIMiniEmbed {
 			bool set(const float        val) { return setFloat(val); }
 			bool set(const double       val) { return setFloat(val); }
 			bool set(const std::string& val) { return setString(val); }
+			bool set(const UIString&    val) { return setString(val); }
 			bool set(const Pixel        val) { return setPixel(val.val); }
 			bool set(const Percent      val) { return setPercent(val.val); }
 			bool set(const Fraction     val) { return setFraction(val.val); }
@@ -371,6 +398,7 @@ namespace UIMiniEmbed {
 			void operator =(const float        val) { set(val); }
 			void operator =(const double       val) { set(val); }
 			void operator =(const std::string& val) { set(val); }
+			void operator =(const UIString&    val) { set(val); }
 			
 			void operator =(const Pixel        val) { set(val); }
 			void operator =(const Percent      val) { set(val); }
@@ -386,6 +414,7 @@ namespace UIMiniEmbed {
 			UIVar(const float        val) { set(val); }
 			UIVar(const double       val) { set(val); }
 			UIVar(const std::string& val) { set(val); }
+			UIVar(const UIString&    val) { set(val); }
 
 			UIVar(const Pixel        val) { set(val); }
 			UIVar(const Percent      val) { set(val); }
@@ -396,6 +425,10 @@ namespace UIMiniEmbed {
 			
 			//UIVar(SP_UIVarInternal   val) { set(val); }
 			
+			static UIVar create(UIArena* pArena) {
+				return UIVar( TInternalTag{}, UIVarInternal::create(pArena) );
+			}
+			
 			
 			bool set(const VarList list) {
 				list_Clear();
@@ -412,6 +445,10 @@ namespace UIMiniEmbed {
 			bool compareRef(const UIVar& other) const {
 				return _spVarInternal->compareRef( other._spVarInternal );
 			}
+			/// identity of the shared value, stable while any var refers to it
+			const void* getId() const {
+				return _spVarInternal.get();
+			}
 			
 			void setValue(const UIVar& other) {
 				_spVarInternal->setValue( other._spVarInternal );
@@ -456,7 +493,8 @@ namespace UIMiniEmbed {
 			using SP_UIVarEnv = std::shared_ptr< UIVarEnv >;
 			
 			std::unordered_map< std::string, UIVar > _map;
-			SP_UIVarEnv                      _parent = nullptr;
+			SP_UIVarEnv                      _parent  = nullptr;
+			UIArena*                         _pArena  = nullptr;
 
 		public:
 			UIVar getVar(const std::string& name, const bool searchParent = false) {
@@ -467,18 +505,35 @@ namespace UIMiniEmbed {
 				if ( searchParent && _parent )
 					return _parent->getVar(name, true);
 				
-				auto var = UIVar{};
+				auto var = UIVar::create(_pArena);
 				_map[name] = var;
 				return var;
 			}
 			
+			/// env that getVar(name, true) takes the var from, the root one when no env holds it yet
+			UIVarEnv* getVarOwner(const std::string& name) {
+				if ( !_parent || _map.count(name) )
+					return this;
+				return _parent->getVarOwner(name);
+			}
+			
+			UIArena* getArena() const { return _pArena; }
+			
 			void  setVar(const std::string& name, UIVar var) {
 				_map[ name ] = var;
 			}
 			
 			static SP_UIVarEnv create(SP_UIVarEnv parent = nullptr) {
-				auto sp = std::make_shared< UIVarEnv >();
+				auto pArena = parent ? parent->_pArena : nullptr;
+				auto sp = arenaMakeShared< UIVarEnv >(pArena);
 				sp->_parent = parent;
+				sp->_pArena = pArena;
+				return sp;
+			}
+			/// root env of an arena document, every env, var and component created below it comes from pArena
+			static SP_UIVarEnv createWithArena(UIArena* pArena) {
+				auto sp = arenaMakeShared< UIVarEnv >(pArena);
+				sp->_pArena = pArena;
 				return sp;
 			}
 	};
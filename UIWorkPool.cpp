@@ -0,0 +1,152 @@
+#pragma once
+
+namespace UIMiniEmbed {
+
+	/// Counts the tasks of one fork/join scope. UIWorkPool::wait() returns once all of them ran,
+	/// including tasks spawned by those tasks into the same group.
+	class UIWorkGroup {
+		friend class UIWorkPool;
+
+		private:
+			std::atomic< size_t > _pending{ 0 };
+
+		public:
+			bool isDone() const { return _pending.load( std::memory_order_acquire ) == 0; }
+	};
+
+	/// Work stealing thread pool.
+	/// Every thread has its own deque. The owner pushes and pops at the back, so recursive work stays
+	/// depth first and cache warm, and idle threads steal the oldest (largest) task from the front of
+	/// someone else's deque. A thread waiting on a group runs tasks instead of blocking.
+	/// Threads that are not part of the pool share slot 0.
+	///
+	///		auto spPool = UIWorkPool::create( std::thread::hardware_concurrency() );
+	class UIWorkPool {
+		private:
+			struct TTask {
+				std::function< void() > fn;
+				UIWorkGroup*            pGroup = nullptr;
+			};
+			struct TWorker {
+				std::mutex          mutex;
+				std::deque< TTask > taskList;
+			};
+
+			std::vector< std::unique_ptr< TWorker > > _workerList;
+			std::vector< std::thread >                _threadList;
+
+			std::atomic< size_t >   _queued{ 0 };
+			std::atomic< bool >     _stop  { false };
+			std::mutex              _sleepMutex;
+			std::condition_variable _sleepCv;
+
+			inline static thread_local UIWorkPool* t_pPool  = nullptr;
+			inline static thread_local size_t      t_index  = 0;
+
+			size_t _getSelfIndex() const {
+				return t_pPool == this ? t_index : 0;
+			}
+
+			bool _pop(const size_t index, TTask& task) {
+				auto& worker = *_workerList[index];
+				std::lock_guard< std::mutex > lock(worker.mutex);
+				if ( worker.taskList.empty() )
+					return false;
+
+				task = std::move( worker.taskList.back() );
+				worker.taskList.pop_back();
+				return true;
+			}
+			bool _steal(const size_t index, TTask& task) {
+				auto& worker = *_workerList[index];
+				std::lock_guard< std::mutex > lock(worker.mutex);
+				if ( worker.taskList.empty() )
+					return false;
+
+				task = std::move( worker.taskList.front() );
+				worker.taskList.pop_front();
+				return true;
+			}
+
+			bool _runOne(const size_t selfIndex) {
+				TTask task;
+				bool found = _pop(selfIndex, task);
+				for(size_t i = 1; !found && i < _workerList.size(); i++)
+					found = _steal( ( selfIndex + i ) % _workerList.size(), task );
+
+				if ( !found )
+					return false;
+
+				_queued.fetch_sub(1, std::memory_order_relaxed);
+				task.fn();
+				task.pGroup->_pending.fetch_sub(1, std::memory_order_release);
+				return true;
+			}
+
+			void _threadMain(const size_t index) {
+				t_pPool = this;
+				t_index = index;
+
+				while( !_stop.load( std::memory_order_acquire ) ) {
+					if ( _runOne(index) )
+						continue;
+
+					std::unique_lock< std::mutex > lock(_sleepMutex);
+					_sleepCv.wait(lock, [this]() { return _queued.load() > 0 || _stop.load(); });
+				}
+			}
+
+		public:
+			/// threadCount includes the caller, which works while it waits. 1 runs everything on the caller.
+			UIWorkPool(const size_t threadCount) {
+				const size_t count = threadCount ? threadCount : 1;
+				for(size_t i = 0; i < count; i++)
+					_workerList.push_back( std::make_unique< TWorker >() );
+
+				for(size_t i = 1; i < count; i++)
+					_threadList.emplace_back( [this, i]() { _threadMain(i); } );
+			}
+			~UIWorkPool() {
+				{
+					std::lock_guard< std::mutex > lock(_sleepMutex);
+					_stop = true;
+				}
+				_sleepCv.notify_all();
+
+				for(auto& thread : _threadList)
+					thread.join();
+			}
+
+			size_t getThreadCount() const { return _workerList.size(); }
+
+			void run(UIWorkGroup& group, std::function< void() > fn) {
+				group._pending.fetch_add(1, std::memory_order_relaxed);
+				_queued.fetch_add(1, std::memory_order_relaxed);
+
+				{
+					auto& worker = *_workerList[ _getSelfIndex() ];
+					std::lock_guard< std::mutex > lock(worker.mutex);
+					worker.taskList.push_back( TTask{ std::move(fn), &group } );
+				}
+
+				if ( _threadList.size() ) {
+					{ std::lock_guard< std::mutex > lock(_sleepMutex); }
+					_sleepCv.notify_one();
+				}
+			}
+
+			void wait(UIWorkGroup& group) {
+				const auto selfIndex = _getSelfIndex();
+				while( !group.isDone() ) {
+					if ( !_runOne(selfIndex) )
+						std::this_thread::yield();
+				}
+			}
+
+			static std::shared_ptr< UIWorkPool > create(const size_t threadCount) {
+				return std::make_shared< UIWorkPool >(threadCount);
+			}
+	};
+	using SP_UIWorkPool = std::shared_ptr< UIWorkPool >;
+
+}
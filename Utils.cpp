@@ -28,6 +28,8 @@ namespace UIMiniEmbed {
 	Vec2 operator-(const Vec2& a, const Vec2& b) { return { a.x - b.x, a.y - b.y }; }
 	Vec2 operator*(const Vec2& a, const Vec2& b) { return { a.x * b.x, a.y * b.y }; }
 	Vec2 operator/(const Vec2& a, const Vec2& b) { return { a.x / b.x, a.y / b.y }; }
+	bool operator==(const Vec2& a, const Vec2& b) { return ( a.x == b.x ) && ( a.y == b.y ); }
+	bool operator!=(const Vec2& a, const Vec2& b) { return !( a == b ); }
 	
 	struct BBox {
 		Vec2 min;
@@ -40,8 +42,30 @@ namespace UIMiniEmbed {
 			return ( min.x <= p.x ) && ( p.x <= max.x ) && ( min.y <= p.y ) && ( p.y <= max.y );
 		}
 		
+		/// edges touching count, like isPointOnBBox
+		bool  isIntersect(const BBox& other) const {
+			return ( min.x <= other.max.x ) && ( other.min.x <= max.x ) && ( min.y <= other.max.y ) && ( other.min.y <= max.y );
+		}
+		/// not valid when the boxes do not overlap
+		BBox  intersect(const BBox& other) const {
+			return BBox{
+				Vec2{ min.x > other.min.x ? min.x : other.min.x, min.y > other.min.y ? min.y : other.min.y },
+				Vec2{ max.x < other.max.x ? max.x : other.max.x, max.y < other.max.y ? max.y : other.max.y },
+			};
+		}
+		/// smallest box holding both
+		BBox  merge(const BBox& other) const {
+			return BBox{
+				Vec2{ min.x < other.min.x ? min.x : other.min.x, min.y < other.min.y ? min.y : other.min.y },
+				Vec2{ max.x > other.max.x ? max.x : other.max.x, max.y > other.max.y ? max.y : other.max.y },
+			};
+		}
+		bool  isValid() const { return ( min.x <= max.x ) && ( min.y <= max.y ); }
+		
 		std::string dump() const { return "BBox{" + min.dump() + ", " + max.dump() + "}"; }
 	};
+	bool operator==(const BBox& a, const BBox& b) { return ( a.min == b.min ) && ( a.max == b.max ); }
+	bool operator!=(const BBox& a, const BBox& b) { return !( a == b ); }
 
 	template< class T >
 	T stringToNumber(const std::string& val, const T defValue = 0) {